@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * adaptive.h - dispatcher with a front cache of the most frequent verbs
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace simplearg {
+
+// Dispatcher<Class> that counts how often each parameter of the root table is looked up and
+// periodically moves the most frequent ones into a small front cache, probed before the hash map.
+// Counting and rebuilding are lock free, so one instance may serve concurrent parsers.
+// The learned order may be exported and passed back to the constructor of a later build
+template<class Class>
+class AdaptiveDispatcher {
+public:
+    using node_type = typename Dispatcher<Class>::node_type;
+    static constexpr std::size_t cache_size = 4;
+
+    template<std::size_t Size>
+    AdaptiveDispatcher(const Parameters<Class, Size>& params, std::initializer_list<std::string_view> hot = {},
+                       std::uint32_t period = 4096)
+      : dispatcher_ { params }, counts_ { std::make_unique<std::atomic<std::uint64_t>[]>(Size) },
+        names_ { std::make_unique<std::string_view[]>(Size) } {
+        while(mask_ + 1 < period) mask_ = mask_ << 1 | 1;
+        for(std::size_t i = 0; i < Size; ++i) if (params[i]) names_[i] = params[i].name();
+        std::size_t i = 0;
+        for(auto name : hot) {
+            auto p = dispatcher_.find(root(), name);
+            if (p != nullptr && i < cache_size && contains(p)) cache_[i++].store(index(p) + 1, std::memory_order_relaxed);
+        }
+    }
+    AdaptiveDispatcher(const AdaptiveDispatcher&) = delete;
+    AdaptiveDispatcher& operator=(const AdaptiveDispatcher&) = delete;
+
+    node_type root() const noexcept { return dispatcher_.root(); }
+    const Parameter<Class>* find(std::string_view name) const noexcept {
+        auto p = find(root(), name);
+        return p != nullptr ? p : positional(root());
+    }
+    const Parameter<Class>* find(node_type node, std::string_view name) const noexcept {
+        if (node != root()) return dispatcher_.find(node, name);
+        for(auto& entry : cache_) {
+            const auto i = entry.load(std::memory_order_relaxed);
+            if (i != 0 && names_[i - 1] == name) return count(begin() + i - 1);
+        }
+        auto p = dispatcher_.find(node, name);
+        return p != nullptr ? count(p) : nullptr;
+    }
+    const Parameter<Class>* positional(node_type node) const noexcept { return dispatcher_.positional(node); }
+    static node_type child(node_type node, const Parameter<Class>& p) noexcept { return Dispatcher<Class>::child(node, p); }
+    Level<Class> level(node_type node) const noexcept { return dispatcher_.level(node); }
+    const Parameter<Class>* begin() const noexcept { return dispatcher_.begin(); }
+    const Parameter<Class>* end() const noexcept { return dispatcher_.end(); }
+    std::size_t size() const noexcept { return dispatcher_.size(); }
+
+    // Parameters in the front cache, empty entries are nullptr
+    std::array<const Parameter<Class>*, cache_size> cached() const noexcept {
+        std::array<const Parameter<Class>*, cache_size> result {};
+        for(std::size_t i = 0; i < cache_size; ++i) {
+            const auto entry = cache_[i].load(std::memory_order_relaxed);
+            result[i] = entry != 0 ? begin() + entry - 1 : nullptr;
+        }
+        return result;
+    }
+    // Root parameters ordered by descending frequency of lookups
+    std::vector<const Parameter<Class>*> order() const {
+        std::vector<const Parameter<Class>*> result {};
+        for(auto& p : dispatcher_.level(root())) if (p) result.push_back(&p);
+        std::stable_sort(result.begin(), result.end(), [this](auto a, auto b) {
+            return counts_[index(a)].load(std::memory_order_relaxed) > counts_[index(b)].load(std::memory_order_relaxed);
+        });
+        return result;
+    }
+    // Writes the learned order as a list of names, suitable for the hot argument of the constructor
+    template<class Stream>
+    Stream& export_order(Stream& out, std::size_t limit = cache_size) const {
+        const auto names = order();
+        out << '{';
+        for(std::size_t i = 0; i < names.size() && i < limit; ++i) out << (i ? ", \"" : " \"") << names[i]->name() << '"';
+        out << " }";
+        return out;
+    }
+
+private:
+    std::size_t index(const Parameter<Class>* p) const noexcept { return static_cast<std::size_t>(p - dispatcher_.begin()); }
+    bool contains(const Parameter<Class>* p) const noexcept { return p >= dispatcher_.begin() && p < dispatcher_.end(); }
+    const Parameter<Class>* count(const Parameter<Class>* p) const noexcept {
+        if (!contains(p)) return p;
+        // plain load and store instead of read-modify-write, concurrent increments may be lost
+        auto& counter = counts_[index(p)];
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        const auto lookups = lookups_.load(std::memory_order_relaxed) + 1;
+        lookups_.store(lookups, std::memory_order_relaxed);
+        if ((lookups & mask_) == 0) rebuild();
+        return p;
+    }
+    // Only one thread rebuilds at a time, others keep using the cache being updated,
+    // every entry is a complete index so a lookup either finds its parameter or falls back to the map
+    void rebuild() const noexcept {
+        if (rebuilding_.test_and_set(std::memory_order_acquire)) return;
+        std::array<const Parameter<Class>*, cache_size> top {};
+        std::array<std::uint64_t, cache_size> hits {};
+        for(auto& p : dispatcher_.level(root())) {
+            if (!p) continue;
+            auto n = counts_[index(&p)].load(std::memory_order_relaxed);
+            const Parameter<Class>* c = &p;
+            for(std::size_t i = 0; i < cache_size && c != nullptr; ++i)
+                if (top[i] == nullptr || n > hits[i]) {
+                    std::swap(top[i], c);
+                    std::swap(hits[i], n);
+                }
+        }
+        for(std::size_t i = 0; i < cache_size; ++i) {
+            const std::uint32_t entry = top[i] == nullptr ? 0 : static_cast<std::uint32_t>(index(top[i]) + 1);
+            if (cache_[i].load(std::memory_order_relaxed) != entry) cache_[i].store(entry, std::memory_order_relaxed);
+        }
+        rebuilding_.clear(std::memory_order_release);
+    }
+
+    Dispatcher<Class> dispatcher_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> counts_;
+    std::unique_ptr<std::string_view[]> names_;
+    std::uint64_t mask_ {}; // period rounded up to a power of two, minus one
+    // indices of cached parameters plus one, zero is an empty entry
+    alignas(64) mutable std::array<std::atomic<std::uint32_t>, cache_size> cache_ {};
+    alignas(64) mutable std::atomic<std::uint64_t> lookups_ {};
+    mutable std::atomic_flag rebuilding_ = ATOMIC_FLAG_INIT;
+};
+
+} // namespace simplearg
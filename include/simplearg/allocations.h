@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * allocations.h - accounting of heap allocations made in a scope
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace simplearg {
+
+struct Allocations {
+    std::size_t count;    // number of allocations
+    std::size_t bytes;    // bytes allocated
+    std::size_t peak;     // peak of bytes live at once, above the level at the start of the scope
+    std::size_t retained; // bytes allocated in the scope and not freed at its end
+};
+
+namespace detail {
+struct AllocationCounters {
+    std::size_t count;
+    std::size_t bytes;
+    std::size_t live;
+    std::size_t peak;
+};
+inline thread_local AllocationCounters allocation_counters {};
+} // namespace detail
+
+// Measures allocations of the current thread between construction and result().
+// Counters are updated only when one translation unit of the program defines SIMPLEARG_ALLOCATIONS
+// before including this header, which replaces the global operator new and delete
+class AllocationScope {
+public:
+    AllocationScope() noexcept : start_ { detail::allocation_counters } {
+        detail::allocation_counters.peak = start_.live;
+    }
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+    ~AllocationScope() {
+        auto& counters = detail::allocation_counters;
+        if (counters.peak < start_.peak) counters.peak = start_.peak;
+    }
+    Allocations result() const noexcept {
+        const auto& counters = detail::allocation_counters;
+        return {
+            counters.count - start_.count,
+            counters.bytes - start_.bytes,
+            counters.peak - start_.live,
+            counters.live > start_.live ? counters.live - start_.live : 0
+        };
+    }
+private:
+    detail::AllocationCounters start_;
+};
+
+} // namespace simplearg
+
+#ifdef SIMPLEARG_ALLOCATIONS
+namespace simplearg::detail {
+// Each block is prefixed with its size, so the live size is known on release.
+// Not inlined into the replaced operators, where compilers would flag the prefix access
+constexpr std::size_t allocation_prefix = alignof(std::max_align_t);
+[[gnu::noinline]] inline void* allocate(std::size_t size) noexcept {
+    auto block = static_cast<char*>(std::malloc(size + allocation_prefix));
+    if (block == nullptr) return nullptr;
+    *reinterpret_cast<std::size_t*>(block) = size;
+    auto& counters = allocation_counters;
+    ++counters.count;
+    counters.bytes += size;
+    counters.live += size;
+    if (counters.live > counters.peak) counters.peak = counters.live;
+    return block + allocation_prefix;
+}
+[[gnu::noinline]] inline void release(void* ptr) noexcept {
+    if (ptr == nullptr) return;
+    auto block = static_cast<char*>(ptr) - allocation_prefix;
+    auto& counters = allocation_counters;
+    const auto size = *reinterpret_cast<std::size_t*>(block);
+    // blocks allocated on another thread may make the live size of this one wrap
+    counters.live = counters.live >= size ? counters.live - size : 0;
+    std::free(block);
+}
+} // namespace simplearg::detail
+
+void* operator new(std::size_t size) {
+    if (auto ptr = simplearg::detail::allocate(size)) return ptr;
+    throw std::bad_alloc {};
+}
+void* operator new[](std::size_t size) {
+    if (auto ptr = simplearg::detail::allocate(size)) return ptr;
+    throw std::bad_alloc {};
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return simplearg::detail::allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return simplearg::detail::allocate(size); }
+void operator delete(void* ptr) noexcept { simplearg::detail::release(ptr); }
+void operator delete[](void* ptr) noexcept { simplearg::detail::release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { simplearg::detail::release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { simplearg::detail::release(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { simplearg::detail::release(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { simplearg::detail::release(ptr); }
+#endif
@@ -8,8 +8,12 @@
  */
 
 #pragma once
+#include <simplearg/choices.h>
+#include <simplearg/suggest.h>
 #include <array>
+#include <atomic>
 #include <charconv>
+#include <cstdint>
 #include <type_traits>
 #include <string>
 #include <string_view>
@@ -19,17 +23,93 @@
 #include <unordered_map>
 #include <iostream>
 #include <tuple>
+#include <vector>
 
 namespace simplearg {
 
 class Arguments;
+class Environment;
+class HandlerPool;
+
+namespace detail {
+// Names a type in a template the way a template parameter would be,
+// so that the type, declared in an optional header, needs to be complete only when the template is used
+template<typename T, typename Dependency>
+struct deferred { using type = T; };
+template<typename T, typename Dependency>
+using deferred_t = typename deferred<T, Dependency>::type;
+template<typename T, typename = void>
+struct has_from_arg : std::false_type {};
+template<typename T>
+struct has_from_arg<T, std::void_t<decltype(from_arg(std::declval<std::string_view>(), std::declval<T&>()))>>
+  : std::true_type {};
+template<typename T, typename = void>
+struct has_arg_expects : std::false_type {};
+template<typename T>
+struct has_arg_expects<T, std::void_t<decltype(arg_expects(std::declval<const T&>()))>> : std::true_type {};
+template<typename T>
+const char* expects(const T& value) noexcept {
+    if constexpr (has_arg_expects<T>::value) return arg_expects(value);
+    else return "a valid value";
+}
+// Probe of parse calls that observes nothing and compiles out
+struct NoProbe {};
+// Runs parallel handlers one after another, in place of a HandlerPool
+struct NoPool {};
+inline constexpr NoPool* no_pool = nullptr;
+// Visitor of dispatched parameters, with the name given to the handler and the offset of its value
+struct NoVisit {
+    template<class P> void operator()(const P*, std::string_view, std::size_t) const noexcept {}
+};
+struct IgnoreRoute {
+    template<class Route> void operator()(const Route&) const noexcept {}
+};
+// Dispatchers matching names by prefixes list candidates of a prefix
+template<class D, typename = void>
+struct has_candidates : std::false_type {};
+template<class D>
+struct has_candidates<D, std::void_t<decltype(D::matches_prefixes)>> : std::bool_constant<D::matches_prefixes> {};
+// Dispatchers accepting clustered short flags map characters to flags
+template<class D, typename = void>
+struct has_flags : std::false_type {};
+template<class D>
+struct has_flags<D, std::void_t<decltype(D::matches_clusters)>> : std::bool_constant<D::matches_clusters> {};
+} // namespace detail
+
+// When a handler runs: immediately when its argument is parsed, after all arguments are parsed,
+// or after all arguments are parsed concurrently with other parallel handlers.
+// Deferred and parallel handlers receive only the value of a name=value argument
+enum class Execution : unsigned char { immediate, deferred, parallel };
 
 template<class Class>
 class Parameter {
 public:
+    using class_type = Class;
     using dispatcher_type = bool(Class::*)(std::string_view, Arguments&);
-    constexpr Parameter(dispatcher_type dispatcher, const char name[], const char description[], const char aliases[])
-      : dispatcher_ { dispatcher }, name_{name}, description_{description}, aliases_{aliases}{}
+    using handler_type = bool(*)(Class&, std::string_view, Arguments&);
+    // env binds the parameter to an environment variable, empty env derives the variable name from name
+    constexpr Parameter(dispatcher_type dispatcher, const char name[], const char description[], const char aliases[],
+                        const char env[] = nullptr)
+      : dispatcher_ { dispatcher }, name_{name}, description_{description}, aliases_{aliases}, env_{env} {}
+    // A free function handler, such as bind<&Class::member>
+    constexpr Parameter(handler_type handler, const char name[], const char description[], const char aliases[],
+                        const char env[] = nullptr)
+      : dispatcher_ {}, name_{name}, description_{description}, aliases_{aliases}, env_{env}, handler_ { handler } {}
+    constexpr Parameter(dispatcher_type dispatcher, const char name[], const char description[], const char aliases[],
+                        Execution execution, const char env[] = nullptr)
+      : dispatcher_ { dispatcher }, name_{name}, description_{description}, aliases_{aliases}, env_{env},
+        execution_ { execution } {}
+    constexpr Parameter(handler_type handler, const char name[], const char description[], const char aliases[],
+                        Execution execution, const char env[] = nullptr)
+      : dispatcher_ {}, name_{name}, description_{description}, aliases_{aliases}, env_{env}, handler_ { handler },
+        execution_ { execution } {}
+    // A group, arguments following the group name are dispatched with the nested table.
+    // The optional dispatcher is called before switching to the nested table
+    template<std::size_t Size>
+    constexpr Parameter(const std::array<Parameter, Size>& table, const char name[], const char description[],
+                        const char aliases[], dispatcher_type dispatcher = nullptr)
+      : dispatcher_ { dispatcher }, name_{name}, description_{description}, aliases_{aliases}, env_{},
+        table_ { table.data() }, table_size_ { Size } {}
     Parameter(Parameter&&) = default;
     Parameter(const Parameter&) = default;
     Parameter& operator=(Parameter&&) = default;
@@ -38,81 +118,245 @@ public:
     constexpr auto description() const noexcept { return description_; }
     constexpr auto aliases() const noexcept { return aliases_; }
     constexpr auto dispatcher() const noexcept { return dispatcher_; }
-    constexpr operator bool() const noexcept { return !(name_ == nullptr || dispatcher_ == nullptr); }
+    constexpr auto handler() const noexcept { return handler_; }
+    constexpr auto env() const noexcept { return env_; }
+    constexpr auto table() const noexcept { return table_; }
+    constexpr auto table_size() const noexcept { return table_size_; }
+    constexpr auto execution() const noexcept { return execution_; }
+    constexpr operator bool() const noexcept {
+        return !(name_ == nullptr || (dispatcher_ == nullptr && handler_ == nullptr && table_ == nullptr));
+    }
+    bool operator()(Class& obj, std::string_view name, Arguments& args) const {
+        if (dispatcher_ != nullptr) return (obj.*dispatcher_)(name, args);
+        if (handler_ != nullptr) return handler_(obj, name, args);
+        return true;
+    }
 private:
     dispatcher_type dispatcher_;
     const char* name_;
     const char* description_;
     const char* aliases_;
+    const char* env_;
+    handler_type handler_ {};
+    const Parameter* table_ {};
+    std::size_t table_size_ {};
+    Execution execution_ {};
 };
 
 template<class Class, std::size_t Size>
 using Parameters = std::array<Parameter<Class>, Size>;
 
+// A range of parameters in one table
+template<class Class>
+class Level {
+public:
+    constexpr Level(const Parameter<Class>* begin, std::size_t size) noexcept : begin_ { begin }, end_ { begin + size } {}
+    constexpr const Parameter<Class>* begin() const noexcept { return begin_; }
+    constexpr const Parameter<Class>* end() const noexcept { return end_; }
+    constexpr std::size_t size() const noexcept { return static_cast<std::size_t>(end_ - begin_); }
+    constexpr bool contains(const Parameter<Class>* p) const noexcept { return p >= begin_ && p < end_; }
+private:
+    const Parameter<Class>* begin_;
+    const Parameter<Class>* end_;
+};
+
+// Maps names and aliases to parameters in all nested tables,
+// may be built once and used for many parse calls
+template<class Class>
+class Dispatcher {
+public:
+    using node_type = const Parameter<Class>*;
+    template<std::size_t Size>
+    Dispatcher(const Parameters<Class, Size>& params) : root_ { params.data(), Size } {
+        add(root_);
+    }
+    node_type root() const noexcept { return root_.begin(); }
+    // Returns parameter matching name, positional parameter or nullptr
+    const Parameter<Class>* find(std::string_view name) const noexcept {
+        auto p = find(root(), name);
+        return p != nullptr ? p : positional(root());
+    }
+    // Returns parameter exactly matching name in the table of node
+    const Parameter<Class>* find(node_type node, std::string_view name) const noexcept {
+        auto p = dispatchers_.find({node, name});
+        return p == dispatchers_.end() ? nullptr : p->second;
+    }
+    const Parameter<Class>* positional(node_type node) const noexcept { return find(node, {}); }
+    static node_type child(node_type, const Parameter<Class>& p) noexcept { return p.table(); }
+    Level<Class> level(node_type node) const noexcept {
+        auto p = levels_.find(node);
+        return p == levels_.end() ? root_ : p->second;
+    }
+    const Parameter<Class>* begin() const noexcept { return root_.begin(); }
+    const Parameter<Class>* end() const noexcept { return root_.end(); }
+    std::size_t size() const noexcept { return root_.size(); }
+private:
+    using key_type = std::pair<node_type, std::string_view>;
+    struct hash {
+        std::size_t operator()(const key_type& key) const noexcept {
+            return std::hash<std::string_view>{}(key.second) ^ std::hash<node_type>{}(key.first);
+        }
+    };
+    void add(Level<Class> level) {
+        if (!levels_.emplace(level.begin(), level).second) return;
+        for(auto& p : level) {
+            if (!p) continue;
+            dispatchers_[{level.begin(), p.name()}] = &p;
+            fillaliases(p.aliases(), [this, &p, &level](std::string_view alias) mutable {
+                if (!alias.empty()) dispatchers_[{level.begin(), alias}] = &p;
+            });
+            if (p.table() != nullptr) add({p.table(), p.table_size()});
+        }
+    }
+    static void fillaliases(const char* aliases, std::function<void(std::string_view)> put) {
+        if (aliases == nullptr || aliases[0] == '\0' ) return;
+        std::string_view current { aliases };
+        while(!current.empty()) {
+            while(!current.empty() && current[0] == ' ') current.remove_prefix(1);
+            auto space = current.find(' ');
+            if (space == current.npos) {
+                put(current);
+                break;
+            } else {
+                put(current.substr(0, space));
+                current.remove_prefix(space+1);
+            }
+        }
+    }
+    Level<Class> root_;
+    std::unordered_map<node_type, Level<Class>> levels_ {};
+    std::unordered_map<key_type, const Parameter<Class>*, hash> dispatchers_ {};
+};
+
+// A tokenized response file, identified by its loader to detect recursive inclusion
+class ResponseFile {
+public:
+    bool same(const ResponseFile& other) const noexcept {
+        return device_ == other.device_ && inode_ == other.inode_;
+    }
+    int count() const noexcept { return static_cast<int>(tokens_.size()); }
+    char** values() noexcept { return tokens_.data(); }
+protected:
+    std::uint64_t device_ {};
+    std::uint64_t inode_ {};
+    std::vector<char*> tokens_ {};
+};
+
+// Loads response files for @file arguments, ResponseFiles in response.h maps them from disk
+class ResponseLoader {
+public:
+    // Returns tokenized file or nullptr with error description appended to errors
+    virtual ResponseFile* load(const char* path, std::string& errors) = 0;
+protected:
+    ~ResponseLoader() = default;
+};
+
+class AsyncParser;
+template<class Class> class Program;
+
 class Arguments {
 public:
-    Arguments(int argc, char** argv) : count_ {argc}, values_{argv} {}
+    Arguments(int argc, const char* const* argv) : count_ {argc}, values_{argv} {}
+    // Expands @file arguments with response files when the cursor reaches them
+    Arguments(int argc, const char* const* argv, ResponseLoader& files) : count_ {argc}, values_{argv}, files_{&files} {}
     Arguments(Arguments&&) = default;
     Arguments(const Arguments&) = default;
     Arguments& operator=(Arguments&&) = default;
     Arguments& operator=(const Arguments&) = default;
-    constexpr operator bool() const noexcept { return count_ > 0; }
-    constexpr bool empty() const noexcept { return count_ <= 0; }
-    Arguments& operator++() noexcept { count_--; values_++; return *this; }
-    template<typename T> std::enable_if_t<std::is_integral_v<T>, bool>
+    operator bool() const noexcept { return count_ > 0 || (count_ == 0 && !frames_.empty()); }
+    bool empty() const noexcept { return !*this; }
+    Arguments& operator++() noexcept { pop(); return *this; }
+    template<typename T> std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && !detail::has_from_arg<T>::value, bool>
     get(T& value) {
         static_assert(std::is_integral_v<T>);
         using l=std::numeric_limits<T>;
-        if (count_ <= 0) return false;
-        const char* end = *values_ + std::strlen(*values_);
-        auto [ptr, ec] = std::from_chars(*values_, end, value);
+        if (!ready()) return false;
+        const char* end = front() + std::strlen(front());
+        auto [ptr, ec] = std::from_chars(front(), end, value);
         if (ec == std::errc::invalid_argument) {
-            message("expects number in place of '", *values_, '\'');
+            message("expects number in place of '", front(), '\'');
             return false;
         }
         if (ec == std::errc::result_out_of_range) {
             message("expects number in range [", std::to_string(l::lowest()), "..",
-                          std::to_string(l::max()), "] in place of '", *values_, '\'');
+                          std::to_string(l::max()), "] in place of '", front(), '\'');
             return false;
         }
-        count_--;
-        values_++;
+        pop();
         return true;
     }
 #if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L)
     bool get(double& value) {
-        if (count_ <= 0) return false;
-        const char* end = *values_ + std::strlen(*values_);
-        auto [ptr, ec] = std::from_chars(*values_, end, value);
+        if (!ready()) return false;
+        const char* end = front() + std::strlen(front());
+        auto [ptr, ec] = std::from_chars(front(), end, value);
         if (ec == std::errc::invalid_argument) {
-            message("expects floating point value in place of '", *values_, '\'');
+            message("expects floating point value in place of '", front(), '\'');
             return false;
         }
         if (ec == std::errc::result_out_of_range) {
-            message("expects number in double range in place of '", *values_, '\'');
+            message("expects number in double range in place of '", front(), '\'');
             return false;
         }
-        count_--;
-        values_++;
+        pop();
         return true;
     }
 #endif
+    bool get(bool& value) {
+        if (!ready()) return false;
+        const int result = detail::boolean(front());
+        if (result < 0) {
+            message("expects one of true false yes no on off 1 0 in place of '", front(), '\'');
+            return false;
+        }
+        value = result != 0;
+        pop();
+        return true;
+    }
+    template<typename E> std::enable_if_t<std::is_enum_v<E> && !detail::has_from_arg<E>::value, bool>
+    get(E& value) {
+        if (!ready()) return false;
+        constexpr auto& table = choices<E>::value;
+        if (auto found = table.find(front())) {
+            value = *found;
+            pop();
+            return true;
+        }
+        message("expects one of");
+        for(auto name : table.names()) message(' ', name);
+        message(" in place of '", front(), '\'');
+        return false;
+    }
+    // User defined types are converted with bool from_arg(std::string_view, T&) found by ADL,
+    // optional const char* arg_expects(const T&) describes the expected value in error messages
+    template<typename T> std::enable_if_t<detail::has_from_arg<T>::value, bool>
+    get(T& value) {
+        if (!ready()) return false;
+        if (!from_arg(std::string_view { front() }, value)) {
+            message("expects ", detail::expects(value), " in place of '", front(), '\'');
+            return false;
+        }
+        pop();
+        return true;
+    }
     bool get(std::string& value) {
-        if (count_ <= 0) return false;
-        value = *values_++;
-        count_--;
+        if (!ready()) return false;
+        value = front();
+        pop();
         return true;
     }
     std::string_view get() {
-        if (count_ <= 0) return {};
-        count_--;
-        return *values_++;
+        if (!ready()) return {};
+        std::string_view result = front();
+        pop();
+        return result;
     }
     template<typename ... T>
     bool getall(T& ... values) {
+        ready();
         if (count_ < 0) return false;
-        if(static_cast<int>(sizeof...(T)) > count_) {
-            message("expects ", std::to_string(sizeof...(T)), " parameters, got only ", std::to_string(count_));
+        if(static_cast<int>(sizeof...(T)) > remaining()) {
+            message("expects ", std::to_string(sizeof...(T)), " parameters, got only ", std::to_string(remaining()));
             return false;
         }
         return (get(values) && ...);
@@ -125,82 +369,447 @@ public:
     }
     bool contains(const char value[]) const noexcept {
         for(int i = 0; i < count_; i++)
-            if( strcmp(value, values_[i]) == 0) return true;
+            if( strcmp(value, values_[i] + (i == 0 ? skip_ : 0)) == 0) return true;
+        for(auto& f : frames_)
+            for(int i = 0; i < f.count; i++)
+                if( strcmp(value, f.values[i]) == 0) return true;
         return false;
     }
+    // Keyed queries over the remaining arguments, including response files, indexed on the first query
+    // and again after the cursor moves. A key ending with '=' matches name=value arguments, other keys
+    // take the next argument of the same frame as the value. The last occurrence of a key wins
+    bool has(std::string_view key) {
+        return lookup(key) != nullptr;
+    }
+    template<typename T>
+    T value(std::string_view key, T fallback) {
+        auto found = lookup(key);
+        if (found == nullptr) return fallback;
+        const bool named = key.back() == '=';
+        if (!named && found->at + 1 == found->end) return fallback;
+        Arguments arg { named ? found->at : found->at + 1, named ? found->skip + key.size() : 0 };
+        T result {};
+        if (arg.get(result)) return result;
+        errors_ += arg.errors();
+        return fallback;
+    }
     template<class Class, std::size_t Size>
     bool parse(Class& obj, const Parameters<Class, Size>& params) {
-        if (count_ <= 0) return false;
-        std::unordered_map<std::string_view, typename Parameter<Class>::dispatcher_type> dispatchers{};
-        for(auto p : params) {
-            if (!p) continue;
-            dispatchers[p.name()] = p.dispatcher();
-            fillaliases(p.aliases(), [&dispatchers, &p](std::string_view alias) mutable {
-                if (!alias.empty()) dispatchers[alias] = p.dispatcher();
-            });
+        if (!ready()) return false;
+        return parse(obj, Dispatcher<Class>{params});
+    }
+    // Dispatcher is either Dispatcher<Class> or StaticDispatcher
+    template<class Class, class D>
+    bool parse(Class& obj, const D& dispatcher) {
+        if (!ready()) return false;
+        return dispatch(obj, dispatcher, detail::NoVisit {}, detail::no_pool);
+    }
+    // Parallel handlers run on the pool, see pool.h, failures of all of them are collected in errors
+    template<class Class, std::size_t Size>
+    bool parse(Class& obj, const Parameters<Class, Size>& params, HandlerPool& pool) {
+        if (!ready()) return false;
+        return parse(obj, Dispatcher<Class>{params}, pool);
+    }
+    template<class Class, class D>
+    bool parse(Class& obj, const D& dispatcher, HandlerPool& pool) {
+        if (!ready()) return false;
+        return dispatch(obj, dispatcher, detail::NoVisit {}, &pool);
+    }
+    // Probe, such as Metrics, observes each handler call: start() before and stop(parameter, start, result) after
+    template<class Class, std::size_t Size, class Probe, typename = typename Probe::is_probe>
+    bool parse(Class& obj, const Parameters<Class, Size>& params, Probe& probe) {
+        if (!ready()) return false;
+        return parse(obj, Dispatcher<Class>{params}, probe);
+    }
+    template<class Class, class D, class Probe, typename = typename Probe::is_probe>
+    bool parse(Class& obj, const D& dispatcher, Probe& probe) {
+        if (!ready()) return false;
+        return dispatch(obj, dispatcher, detail::NoVisit {}, detail::no_pool, &probe);
+    }
+    // Parameters bound to environment variables and not given in arguments are
+    // dispatched after the arguments with the variable value as the only argument, see environment.h
+    template<class Class, std::size_t Size>
+    bool parse(Class& obj, const Parameters<Class, Size>& params, const detail::deferred_t<Environment, Class>& env) {
+        return parse(obj, Dispatcher<Class>{params}, env);
+    }
+    template<class Class, class D>
+    bool parse(Class& obj, const D& dispatcher, const detail::deferred_t<Environment, Class>& env) {
+        std::vector<bool> given(dispatcher.size());
+        if (ready() && !dispatch(obj, dispatcher, [&given, &dispatcher](const Parameter<Class>* p, std::string_view, std::size_t) {
+            if (p >= dispatcher.begin() && p < dispatcher.end())
+                given[static_cast<std::size_t>(p - dispatcher.begin())] = true;
+        }, detail::no_pool)) return false;
+        if (count_ < 0) return false;
+        for(auto& p : dispatcher) {
+            if (!p || given[static_cast<std::size_t>(&p - dispatcher.begin())]) continue;
+            const char* value = env.find(p.env(), p.name());
+            if (value == nullptr) continue;
+            Arguments arg { &value, 0 };
+            if (! p(obj, p.name(), arg) ) {
+                message(arg.errors());
+                return false;
+            }
         }
-        auto posarg = dispatchers.find("");
+        return true;
+    }
+private:
+    friend class AsyncParser;
+    friend class Recorder;
+    template<class Class> friend class Program;
+    template<class Class>
+    struct Call {
+        const Parameter<Class>* parameter;
+        std::string_view name;
+        const char* const* value;
+        std::size_t skip;
+        std::string errors;
+    };
+    template<class Class, class D, class Visitor, class Runner, class Probe = detail::NoProbe>
+    bool dispatch(Class& obj, const D& dispatcher, Visitor&& visit, Runner* pool, Probe* probe = nullptr) {
+        auto node = dispatcher.root();
+        std::vector<Call<Class>> calls {};
         for(std::string_view param = get(); count_ >= 0 && ! param.empty(); param = get()) {
+            const auto token = param;
             const auto eq = param.find('=');
             if (eq != param.npos) {
                 param = param.substr(0, eq + 1);
             }
-            auto p = dispatchers.find(param);
-            if (p == dispatchers.end()) p = posarg;
-            if (p == dispatchers.end()) {
-                message("Unknown verb '", param, "' expected one of:");
-                for(auto p : params) message(' ', p.name());
-                return false;
+            auto p = dispatcher.find(node, param);
+            const bool dotted = p == nullptr && (p = descend(dispatcher, node, param)) != nullptr;
+            if constexpr (detail::has_flags<D>::value) {
+                if (p == nullptr && clustered(dispatcher, node, token)) {
+                    if (!flags(obj, dispatcher, node, token, calls, visit, probe)) return false;
+                    continue;
+                }
             }
-            const auto saved = eq != param.npos ? unget(eq + 1) : nothing;
-            if (! (obj.*p->second)(param, *this) ) {
-                revert(saved);
+            if (p == nullptr && ambiguous(dispatcher, node, param)) return false;
+            if (p == nullptr) p = dispatcher.positional(node);
+            if (p == nullptr) return unknown(param, dispatcher.level(node));
+            if (!call(obj, *p, param, eq != param.npos ? eq + 1 : 0, calls, visit, probe)) return false;
+            if (p->table() != nullptr && !dotted && p->execution() == Execution::immediate) node = dispatcher.child(node, *p);
+        }
+
+        return count_ >= 0 && complete(obj, calls, pool, probe);
+    }
+    // Calls the handler of the parameter just taken, or records the call when it is not immediate.
+    // A nonzero pos is the offset of the value in the argument taken with the name
+    template<class Class, class Visitor, class Probe>
+    bool call(Class& obj, const Parameter<Class>& p, std::string_view name, std::size_t pos,
+              std::vector<Call<Class>>& calls, Visitor& visit, Probe* probe) {
+        visit(&p, name, pos);
+        if (p.execution() != Execution::immediate) {
+            calls.push_back({&p, name, pos != 0 ? values_ - 1 : nullptr, pos, {}});
+            return true;
+        }
+        if (pos != 0) unget(pos);
+        if constexpr (std::is_same_v<Probe, detail::NoProbe>) {
+            return p(obj, name, *this);
+        } else {
+            const auto start = probe->start();
+            const bool result = p(obj, name, *this);
+            probe->stop(p, start, result);
+            return result;
+        }
+    }
+    // Short flags clustered in one argument, -abc for -a -b -c, known to the dispatcher.
+    // A flag taking a value, named as -o=, ends the cluster and takes the rest of it or the next argument
+    template<class D>
+    static bool clustered(const D& dispatcher, typename D::node_type node, std::string_view token) noexcept {
+        if (token.size() < 2 || token[0] != '-' || token[1] == '-') return false;
+        for(std::size_t i = 1; i < token.size(); ++i) {
+            auto route = dispatcher.flag(node, token[i]);
+            if (route == nullptr) return false;
+            if (route->name.back() == '=') return true;
+        }
+        return true;
+    }
+    template<class Class, class D, class Visitor, class Probe>
+    bool flags(Class& obj, const D& dispatcher, typename D::node_type node, std::string_view token,
+               std::vector<Call<Class>>& calls, Visitor& visit, Probe* probe) {
+        const auto cluster = values_;
+        std::string_view last {};
+        for(std::size_t i = 1; i < token.size(); ++i) {
+            if (values_ != cluster) {
+                message("flag '", last, "' takes arguments and cannot be followed by others in '", token, '\'');
                 return false;
             }
-            revert(saved);
+            const auto& route = *dispatcher.flag(node, token[i]);
+            last = route.name;
+            if (route.name.back() != '=') {
+                if (!call(obj, *route.parameter, route.name, 0, calls, visit, probe)) return false;
+                continue;
+            }
+            auto pos = i + 1 + (i + 1 < token.size() && token[i + 1] == '=');
+            if (pos == token.size()) pos = 0;
+            // values of name=value start past the skipped part of the argument
+            return call(obj, *route.parameter, route.name, pos != 0 ? pos + static_cast<std::size_t>(token.data() - values_[-1]) : 0,
+                        calls, visit, probe);
         }
-
         return true;
     }
-private:
-    static constexpr inline std::pair<char**, char*> nothing {};
-    std::pair<char**, char*> unget(int pos) noexcept {
-        if (count_ < 0) return {};
+    // Runs deferred and parallel calls, the probe observes them as immediate ones,
+    // from the threads of the pool for parallel calls
+    template<class Class, class Runner, class Probe = detail::NoProbe>
+    bool complete(Class& obj, std::vector<Call<Class>>& calls, Runner* pool, Probe* probe = nullptr) {
+        if (calls.empty()) return true;
+        auto call = [&obj, &calls, probe](std::size_t i) {
+            auto& c = calls[i];
+            Arguments arg { c.value == nullptr ? 0 : 1, c.value };
+            arg.skip_ = c.value == nullptr ? 0 : c.skip;
+            bool result;
+            if constexpr (std::is_same_v<Probe, detail::NoProbe>) {
+                result = (*c.parameter)(obj, c.name, arg);
+            } else {
+                const auto start = probe->start();
+                result = (*c.parameter)(obj, c.name, arg);
+                probe->stop(*c.parameter, start, result);
+            }
+            if (!result) c.errors = arg.errors().empty() ? std::string { "failed" } : arg.errors();
+        };
+        std::vector<std::size_t> parallel {};
+        for(std::size_t i = 0; i < calls.size(); ++i)
+            if (calls[i].parameter->execution() == Execution::parallel) parallel.push_back(i);
+        if constexpr (!std::is_same_v<Runner, detail::NoPool>) {
+            if (pool != nullptr && parallel.size() > 1) {
+                pool->run(parallel.size(), [&call, &parallel](std::size_t i) { call(parallel[i]); });
+                parallel.clear();
+            }
+        }
+        for(auto i : parallel) call(i);
+        for(std::size_t i = 0; i < calls.size(); ++i)
+            if (calls[i].parameter->execution() == Execution::deferred) call(i);
+        bool result = true;
+        for(auto& c : calls) {
+            if (c.errors.empty()) continue;
+            message(result ? "" : "; ", c.name, ' ', c.errors);
+            result = false;
+        }
+        return result;
+    }
+    // Routes a dotted name such as --db.pool.size= segment by segment through
+    // nested tables of groups named with a trailing dot, --db. and pool.
+    template<class D>
+    static auto descend(const D& dispatcher, typename D::node_type node, std::string_view name) noexcept
+      -> decltype(dispatcher.find(node, name)) {
+        for(auto dot = name.find('.'); dot != name.npos; dot = name.find('.')) {
+            auto group = dispatcher.find(node, name.substr(0, dot + 1));
+            if (group == nullptr || group->table() == nullptr) return nullptr;
+            node = dispatcher.child(node, *group);
+            name.remove_prefix(dot + 1);
+            if (auto p = dispatcher.find(node, name)) return p;
+        }
+        return nullptr;
+    }
+    template<class D>
+    bool ambiguous(const D& dispatcher, typename D::node_type node, std::string_view param) {
+        if constexpr (detail::has_candidates<D>::value) {
+            if (dispatcher.candidates(node, param, detail::IgnoreRoute {}) < 2) return false;
+            message("Ambiguous verb '", param, "' matches:");
+            dispatcher.candidates(node, param, [this](const auto& route) { message(' ', route.name); });
+            return true;
+        }
+        return false;
+    }
+    // Small tables are listed in full, larger ones suggest names and aliases closest to the unknown one
+    template<class Level>
+    bool unknown(std::string_view param, const Level& level) {
+        constexpr std::size_t listed = 16;
+        if (static_cast<std::size_t>(level.end() - level.begin()) <= listed) {
+            message("Unknown verb '", param, "' expected one of:");
+            for(auto& p : level) if (p) message(' ', p.name());
+            return false;
+        }
+        detail::Suggestions<3> suggestions { param };
+        for(auto& p : level) {
+            if (!p) continue;
+            suggestions.add(p.name());
+            std::string_view aliases { p.aliases() != nullptr ? p.aliases() : "" };
+            while(!aliases.empty()) {
+                const auto space = aliases.find(' ');
+                suggestions.add(aliases.substr(0, space));
+                aliases.remove_prefix(space == aliases.npos ? aliases.size() : space + 1);
+            }
+        }
+        message("Unknown verb '", param, '\'');
+        if (suggestions.size() != 0) message(", did you mean:");
+        for(auto& s : suggestions) message(' ', s.name);
+        return false;
+    }
+    Arguments(const char* const* value, std::size_t skip) : count_ { 1 }, values_ { value }, skip_ { skip } {}
+    struct Found {
+        const char* const* at;
+        const char* const* end;
+        std::size_t skip;
+    };
+    struct Cursor {
+        const char* const* values;
+        int count;
+        std::size_t skip;
+        std::size_t frames;
+        bool operator==(const Cursor& other) const noexcept {
+            return values == other.values && count == other.count && skip == other.skip && frames == other.frames;
+        }
+    };
+    // The index covers the arguments after the cursor, enclosing frames and response files
+    // they name, it is rebuilt when the cursor or the frame changes
+    const Found* lookup(std::string_view key) {
+        if (key.empty() || count_ < 0) return nullptr;
+        const Cursor cursor { values_, count_, skip_, frames_.size() };
+        if (!(indexed_ == cursor)) {
+            index_.clear();
+            std::vector<ResponseFile*> open {};
+            if (file_ != nullptr) open.push_back(file_);
+            for(auto& f : frames_) if (f.file != nullptr) open.push_back(f.file);
+            index(values_, count_, skip_, open);
+            for(auto f = frames_.rbegin(); f != frames_.rend(); ++f) index(f->values, f->count, 0, open);
+            indexed_ = cursor;
+        }
+        auto found = index_.find(key);
+        return found == index_.end() ? nullptr : &found->second;
+    }
+    void index(const char* const* values, int count, std::size_t skip, std::vector<ResponseFile*>& open) {
+        for(int i = 0; i < count; i++) {
+            const char* value = values[i] + (i == 0 ? skip : 0);
+            if (files_ != nullptr && value[0] == '@' && (i != 0 || skip == 0)) {
+                std::string ignored {};
+                auto file = files_->load(value + 1, ignored);
+                bool recursive = file == nullptr;
+                for(auto f : open) recursive = recursive || f->same(*file);
+                if (recursive) continue;
+                open.push_back(file);
+                index(file->values(), file->count(), 0, open);
+                open.pop_back();
+                continue;
+            }
+            std::string_view arg { value };
+            const auto eq = arg.find('=');
+            index_[arg.substr(0, eq == arg.npos ? arg.npos : eq + 1)] = { values + i, values + count, i == 0 ? skip : 0 };
+        }
+    }
+    const char* front() const noexcept { return values_[0] + skip_; }
+    void pop() noexcept {
+        count_--;
+        values_++;
+        skip_ = 0;
+    }
+    // Steps back to the value part of the last name=value argument
+    void unget(std::size_t pos) noexcept {
+        if (count_ < 0) return;
         count_++;
         values_--;
-        std::pair<char**, char*> result { values_, *values_ };
-        values_[0] += pos;
+        skip_ = pos;
+    }
+    struct Frame {
+        int count;
+        const char* const* values;
+        ResponseFile* file;
+    };
+    int remaining() const noexcept {
+        int result = count_;
+        for(auto& f : frames_) result += f.count;
         return result;
     }
-    static void revert(std::pair<char**, char*> v) noexcept {
-        if (v.first != nullptr && v.second != nullptr) {
-            *v.first = v.second;
+    // Resumes the enclosing frame when the current one is exhausted
+    // and expands @file at the cursor, unless it is a value of name=value
+    bool ready() {
+        for(;;) {
+            if (count_ == 0 && !frames_.empty()) {
+                count_ = frames_.back().count;
+                values_ = frames_.back().values;
+                file_ = frames_.back().file;
+                frames_.pop_back();
+                continue;
+            }
+            if (count_ <= 0 || files_ == nullptr || values_[0][0] != '@' || skip_ != 0) break;
+            if (!include(values_[0] + 1)) break;
         }
+        return count_ > 0;
+    }
+    bool include(const char* path) {
+        auto file = files_->load(path, errors_);
+        if (file == nullptr) {
+            count_ = -1;
+            return false;
+        }
+        bool recursive = file_ != nullptr && file_->same(*file);
+        for(auto& f : frames_) recursive = recursive || (f.file != nullptr && f.file->same(*file));
+        if (recursive) {
+            message("recursive response file '", path, '\'');
+            return false;
+        }
+        frames_.push_back({count_ - 1, values_ + 1, file_});
+        count_ = file->count();
+        values_ = file->values();
+        file_ = file;
+        return true;
     }
     template<typename ... T>
     void message(T ... str) {
         count_= -1;
         ((errors_ += str), ...);
     }
-    void fillaliases(const char* aliases, std::function<void(std::string_view)> put) {
-        if (aliases == nullptr || aliases[0] == '\0' ) return;
-        std::string_view current { aliases };
-        while(!current.empty()) {
-            while(!current.empty() && current[0] == ' ') current.remove_prefix(1);
-            auto space = current.find(' ');
-            if (space == current.npos) {
-                put(current);
-                break;
-            } else {
-                put(current.substr(0, space));
-                current.remove_prefix(space+1);
-            }
-        }
-    }
     int count_;
-    char** values_;
+    const char* const* values_;
     std::string errors_;
+    std::size_t skip_ {};
+    std::unordered_map<std::string_view, Found> index_ {};
+    Cursor indexed_ {};
+    ResponseLoader* files_ {};
+    ResponseFile* file_ {};
+    std::vector<Frame> frames_ {};
+};
+
+namespace detail {
+template<typename M>
+struct member_of;
+template<class Class, typename T>
+struct member_of<T Class::*> { using type = Class; };
+
+template<auto Member, auto ... Members, class Class>
+constexpr auto& member(Class& obj) noexcept {
+    if constexpr (sizeof...(Members) == 0) return obj.*Member;
+    else return member<Members...>(obj.*Member);
+}
+
+template<auto Member, auto ... Members, class Class>
+void copy(const Class& from, Class& to) {
+    member<Member, Members...>(to) = member<Member, Members...>(from);
+}
+
+// Maps bind handlers to functions copying their member. Each handler registers a static entry
+// on its first call, entries form a lock free list
+template<class Class>
+class Copiers {
+public:
+    using handler_type = bool (*)(Class&, std::string_view, Arguments&);
+    using copier_type = void (*)(const Class&, Class&);
+    struct Entry {
+        Entry(handler_type handler, copier_type copier) noexcept : handler { handler }, copier { copier } {
+            next = head_.load(std::memory_order_relaxed);
+            while(!head_.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed)) {}
+        }
+        const handler_type handler;
+        const copier_type copier;
+        Entry* next;
+    };
+    static copier_type find(handler_type handler) noexcept {
+        for(auto entry = head_.load(std::memory_order_acquire); entry != nullptr; entry = entry->next)
+            if (entry->handler == handler) return entry->copier;
+        return nullptr;
+    }
+private:
+    inline static std::atomic<Entry*> head_ {};
 };
+} // namespace detail
+
+// Handler that converts the argument into a data member, possibly nested: bind<&Config::db, &Db::pool, &Pool::size>
+template<auto Member, auto ... Members>
+bool bind(typename detail::member_of<decltype(Member)>::type& obj, std::string_view, Arguments& args) {
+    using Class = typename detail::member_of<decltype(Member)>::type;
+    static const typename detail::Copiers<Class>::Entry copier { &bind<Member, Members...>, &detail::copy<Member, Members...> };
+    static_cast<void>(copier);
+    return args.get(detail::member<Member, Members...>(obj));
+}
 
 template<class Stream, class Class, std::size_t Size>
 Stream& print(Stream& out, const Parameters<Class, Size>& params, std::string_view bullet = " - ", std::string_view alias_label = "Aliases: ") {
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * async.h - coroutine handlers and asynchronous parsing, requires C++20
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <utility>
+
+namespace simplearg {
+
+// Lazily started coroutine returning bool, awaitable from another Task
+class Task {
+public:
+    struct promise_type {
+        bool value {};
+        bool started {};
+        std::coroutine_handle<> continuation { std::noop_coroutine() };
+        Task get_return_object() noexcept { return Task { handle_type::from_promise(*this) }; }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        auto final_suspend() const noexcept {
+            struct Final {
+                bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<> await_suspend(handle_type h) const noexcept { return h.promise().continuation; }
+                void await_resume() const noexcept {}
+            };
+            return Final {};
+        }
+        void return_value(bool result) noexcept { value = result; }
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+    Task(Task&& that) noexcept : handle_ { std::exchange(that.handle_, {}) } {}
+    Task& operator=(Task&& that) noexcept {
+        if (this != &that) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(that.handle_, {});
+        }
+        return *this;
+    }
+    ~Task() { if (handle_) handle_.destroy(); }
+
+    // Runs the coroutine up to its first suspension, no-op if already started
+    void start() {
+        if (!handle_ || handle_.promise().started) return;
+        handle_.promise().started = true;
+        handle_.resume();
+    }
+    bool done() const noexcept { return !handle_ || handle_.done(); }
+    bool result() const noexcept { return handle_ && handle_.promise().value; }
+
+    bool await_ready() const noexcept { return done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+        handle_.promise().continuation = continuation;
+        if (handle_.promise().started) return std::noop_coroutine();
+        handle_.promise().started = true;
+        return handle_;
+    }
+    bool await_resume() const noexcept { return result(); }
+private:
+    explicit Task(handle_type handle) noexcept : handle_ { handle } {}
+    handle_type handle_ {};
+};
+
+// Single threaded run queue, enough to drive handlers without an external runtime
+class Executor {
+public:
+    // co_await executor.schedule() suspends the coroutine and queues it for resumption
+    auto schedule() noexcept {
+        struct Awaiter {
+            Executor& executor;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { executor.post(h); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter { *this };
+    }
+    void post(std::coroutine_handle<> h) { queue_.push_back(h); }
+    // Resumes queued coroutines until the queue is empty, returns number of resumptions
+    std::size_t run() {
+        std::size_t count {};
+        while(!queue_.empty()) {
+            auto h = queue_.front();
+            queue_.pop_front();
+            h.resume();
+            ++count;
+        }
+        return count;
+    }
+    bool run(Task& task) {
+        task.start();
+        run();
+        return task.done() && task.result();
+    }
+private:
+    std::deque<std::coroutine_handle<>> queue_ {};
+};
+
+template<class Class>
+class AsyncParameter {
+public:
+    using class_type = Class;
+    using handler_type = Task (Class::*)(std::string_view, Arguments&);
+    constexpr AsyncParameter(handler_type handler, const char name[], const char description[], const char aliases[],
+                             Execution execution = Execution::immediate)
+      : handler_ { handler }, name_{name}, description_{description}, aliases_{aliases}, execution_ { execution } {}
+    constexpr auto name() const noexcept { return name_; }
+    constexpr auto description() const noexcept { return description_; }
+    constexpr auto aliases() const noexcept { return aliases_; }
+    constexpr auto execution() const noexcept { return execution_; }
+    constexpr operator bool() const noexcept { return name_ != nullptr && handler_ != nullptr; }
+    Task operator()(Class& obj, std::string_view name, Arguments& args) const { return (obj.*handler_)(name, args); }
+private:
+    handler_type handler_;
+    const char* name_;
+    const char* description_;
+    const char* aliases_;
+    Execution execution_;
+};
+
+template<class Class, std::size_t Size>
+using AsyncParameters = std::array<AsyncParameter<Class>, Size>;
+
+// Maps names and aliases of a flat table of coroutine handlers
+template<class Class>
+class AsyncDispatcher {
+public:
+    template<std::size_t Size>
+    AsyncDispatcher(const AsyncParameters<Class, Size>& params) : begin_ { params.data() }, end_ { params.data() + Size } {
+        for(auto& p : params) {
+            if (!p) continue;
+            map_[p.name()] = &p;
+            std::string_view aliases { p.aliases() != nullptr ? p.aliases() : "" };
+            while(!aliases.empty()) {
+                const auto space = aliases.find(' ');
+                const auto alias = aliases.substr(0, space);
+                if (!alias.empty()) map_[alias] = &p;
+                aliases.remove_prefix(space == aliases.npos ? aliases.size() : space + 1);
+            }
+        }
+    }
+    // Returns parameter matching name, positional parameter or nullptr
+    const AsyncParameter<Class>* find(std::string_view name) const noexcept {
+        auto p = map_.find(name);
+        if (p != map_.end()) return p->second;
+        p = map_.find({});
+        return p == map_.end() ? nullptr : p->second;
+    }
+    const AsyncParameter<Class>* begin() const noexcept { return begin_; }
+    const AsyncParameter<Class>* end() const noexcept { return end_; }
+private:
+    const AsyncParameter<Class>* begin_;
+    const AsyncParameter<Class>* end_;
+    std::unordered_map<std::string_view, const AsyncParameter<Class>*> map_ {};
+};
+
+class AsyncParser {
+public:
+    // Awaits immediate handlers one by one in order of arguments. Parallel handlers receive only
+    // the value of name=value, are started as soon as seen and awaited after all arguments are parsed.
+    // Deferred handlers are awaited after that, in order
+    template<class Class>
+    static Task parse(Arguments& args, Class& obj, const AsyncDispatcher<Class>& dispatcher) {
+        struct Pending {
+            const AsyncParameter<Class>* parameter;
+            std::string_view name;
+            Arguments args;
+            Task task;
+        };
+        std::deque<Pending> pending {};
+        bool result = true;
+        for(std::string_view param = args.get(); args.count_ >= 0 && !param.empty(); param = args.get()) {
+            const auto eq = param.find('=');
+            if (eq != param.npos) param = param.substr(0, eq + 1);
+            auto p = dispatcher.find(param);
+            if (p == nullptr) {
+                args.unknown(param, dispatcher);
+                break;
+            }
+            if (p->execution() == Execution::immediate) {
+                if (eq != param.npos) args.unget(eq + 1);
+                if (!co_await (*p)(obj, param, args)) {
+                    result = false;
+                    break;
+                }
+                continue;
+            }
+            auto& call = pending.emplace_back(Pending { p, param,
+                eq != param.npos ? Arguments { args.values_ - 1, eq + 1 } : Arguments { 0, nullptr }, Task {} });
+            call.task = (*p)(obj, param, call.args);
+            if (p->execution() == Execution::parallel) call.task.start();
+        }
+        result = result && args.count_ >= 0;
+        // started handlers are awaited even on failure, they may still be queued for resumption
+        for(auto mode : { Execution::parallel, Execution::deferred })
+            for(auto& call : pending) {
+                if (call.parameter->execution() != mode || (mode == Execution::deferred && !result)) continue;
+                if (co_await call.task) continue;
+                args.message(args.errors_.empty() ? "" : "; ", call.name, ' ',
+                             call.args.errors().empty() ? std::string_view { "failed" } : std::string_view { call.args.errors() });
+                result = false;
+            }
+        co_return result;
+    }
+    // The task starts lazily, a temporary dispatcher would be gone by then
+    template<class Class>
+    static Task parse(Arguments& args, Class& obj, AsyncDispatcher<Class>&& dispatcher) = delete;
+    // Keeps the dispatcher in the coroutine frame
+    template<class Class>
+    static Task owning(Arguments& args, Class& obj, AsyncDispatcher<Class> dispatcher) {
+        co_return co_await parse(args, obj, static_cast<const AsyncDispatcher<Class>&>(dispatcher));
+    }
+};
+
+template<class Class>
+Task async_parse(Arguments& args, Class& obj, const AsyncDispatcher<Class>& dispatcher) {
+    return AsyncParser::parse(args, obj, dispatcher);
+}
+template<class Class>
+Task async_parse(Arguments& args, Class& obj, AsyncDispatcher<Class>&& dispatcher) {
+    return AsyncParser::owning(args, obj, std::move(dispatcher));
+}
+
+} // namespace simplearg
+#endif
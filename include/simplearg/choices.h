@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * choices.h - constexpr name tables for enum and boolean values
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+namespace simplearg {
+
+// Name to value table with a perfect hash computed at compile time. Names are hashed into buckets,
+// each bucket gets the displacement that places all its names into free slots (CHD), largest buckets first.
+// When no displacement is found within a bound, names are looked up with a binary search instead
+template<typename E, std::size_t Size>
+class Choices {
+public:
+    static_assert(Size < 0xFFFF, "too many choices");
+    constexpr Choices(const std::pair<const char*, E> (&table)[Size]) {
+        for(std::size_t i = 0; i < Size; ++i) {
+            names_[i] = table[i].first;
+            values_[i] = table[i].second;
+            for(std::size_t j = 0; j < i; ++j)
+                if (names_[i] == names_[j]) throw "duplicate name in choices";
+        }
+        hashed_ = place();
+        if (!hashed_) sort();
+    }
+    // Returns pointer to the value matching name or nullptr
+    constexpr const E* find(std::string_view name) const noexcept {
+        if (!hashed_) return search(name);
+        const auto h = hash(name);
+        const auto i = slots_[slot(h, displacements_[h & (buckets - 1)])];
+        return i != 0 && names_[i - 1] == name ? &values_[i - 1] : nullptr;
+    }
+    constexpr const std::array<std::string_view, Size>& names() const noexcept { return names_; }
+private:
+    static constexpr std::size_t power(std::size_t size) noexcept {
+        std::size_t result = 1;
+        while(result < size) result <<= 1;
+        return result;
+    }
+    static constexpr std::size_t slots = power(Size * 2);
+    static constexpr std::size_t buckets = power(Size / 2 + 1);
+    static constexpr std::uint32_t attempts = 4096;
+    static constexpr std::uint64_t hash(std::string_view name) noexcept {
+        std::uint64_t result = 14695981039346656037ull;
+        for(auto chr : name) result = (result ^ static_cast<unsigned char>(chr)) * 1099511628211ull;
+        result ^= result >> 33;
+        result *= 0xff51afd7ed558ccdull;
+        return result ^ (result >> 33);
+    }
+    // Displacement d walks the slots of a name with an odd step, so a name may take any slot
+    static constexpr std::size_t slot(std::uint64_t h, std::uint32_t d) noexcept {
+        return static_cast<std::size_t>(((h >> 32) + d * ((h >> 16) | 1)) & (slots - 1));
+    }
+    constexpr bool place() noexcept {
+        std::array<std::uint16_t, buckets> sizes {};
+        std::size_t largest = 0;
+        for(std::size_t i = 0; i < Size; ++i) {
+            const auto size = ++sizes[hash(names_[i]) & (buckets - 1)];
+            if (size > largest) largest = size;
+        }
+        for(auto size = largest; size > 0; --size)
+            for(std::size_t b = 0; b < buckets; ++b)
+                if (sizes[b] == size && !displace(b)) return false;
+        return true;
+    }
+    constexpr bool displace(std::size_t bucket) noexcept {
+        for(std::uint32_t d = 0; d < attempts; ++d) {
+            std::size_t placed = 0;
+            bool fits = true;
+            for(std::size_t i = 0; i < Size; ++i) {
+                const auto h = hash(names_[i]);
+                if ((h & (buckets - 1)) != bucket) continue;
+                auto& entry = slots_[slot(h, d)];
+                fits = entry == 0;
+                if (!fits) break;
+                entry = static_cast<std::uint16_t>(i + 1);
+                ++placed;
+            }
+            if (fits) {
+                displacements_[bucket] = d;
+                return true;
+            }
+            for(std::size_t i = 0; i < Size && placed > 0; ++i) {
+                const auto h = hash(names_[i]);
+                if ((h & (buckets - 1)) != bucket || slots_[slot(h, d)] != i + 1) continue;
+                slots_[slot(h, d)] = 0;
+                --placed;
+            }
+        }
+        return false;
+    }
+    // Fallback: slots hold indices of names in sorted order, heap sorted to stay within constexpr limits
+    constexpr bool less(std::size_t a, std::size_t b) const noexcept { return names_[slots_[a]] < names_[slots_[b]]; }
+    constexpr void swap(std::size_t a, std::size_t b) noexcept {
+        const auto index = slots_[a];
+        slots_[a] = slots_[b];
+        slots_[b] = index;
+    }
+    constexpr void sift(std::size_t root, std::size_t size) noexcept {
+        for(auto child = 2 * root + 1; child < size; root = child, child = 2 * root + 1) {
+            if (child + 1 < size && less(child, child + 1)) ++child;
+            if (!less(root, child)) return;
+            swap(root, child);
+        }
+    }
+    constexpr void sort() noexcept {
+        for(std::size_t i = 0; i < Size; ++i) slots_[i] = static_cast<std::uint16_t>(i);
+        for(auto i = Size / 2; i-- > 0;) sift(i, Size);
+        for(auto end = Size; end > 1; --end) {
+            swap(0, end - 1);
+            sift(0, end - 1);
+        }
+    }
+    constexpr const E* search(std::string_view name) const noexcept {
+        std::size_t first = 0, last = Size;
+        while(first < last) {
+            const auto middle = first + (last - first) / 2;
+            if (names_[slots_[middle]] < name) first = middle + 1;
+            else last = middle;
+        }
+        return first < Size && names_[slots_[first]] == name ? &values_[slots_[first]] : nullptr;
+    }
+    std::array<std::string_view, Size> names_ {};
+    std::array<E, Size> values_ {};
+    std::array<std::uint16_t, slots> slots_ {};
+    std::array<std::uint32_t, buckets> displacements_ {};
+    bool hashed_ {};
+};
+
+template<typename E, std::size_t Size>
+constexpr Choices<E, Size> make_choices(const std::pair<const char*, E> (&table)[Size]) {
+    return { table };
+}
+
+// Specialize with a static constexpr member value = make_choices<E>({...}) to enable Arguments::get(E&)
+template<typename E>
+struct choices;
+
+namespace detail {
+constexpr std::uint64_t pack(std::string_view str) noexcept {
+    std::uint64_t result {};
+    for(std::size_t i = 0; i < str.size(); ++i)
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        result |= std::uint64_t { static_cast<unsigned char>(str[i]) } << (56 - 8 * i);
+#else
+        result |= std::uint64_t { static_cast<unsigned char>(str[i]) } << (8 * i);
+#endif
+    return result;
+}
+
+// Parses true/false/yes/no/on/off/1/0 ignoring case of letters,
+// returns 1 for true, 0 for false and -1 for anything else
+inline int boolean(const char* str) noexcept {
+    constexpr std::uint64_t lower = 0x2020202020202020ull;
+    const std::size_t length = strnlen(str, 6);
+    std::uint64_t key {};
+    std::memcpy(&key, str, length < 6 ? length : 0);
+    if (length > 1) key |= lower;
+    switch(length) {
+    case 1: return key == pack("1") ? 1 : key == pack("0") ? 0 : -1;
+    case 2: return key == (pack("on") | lower) ? 1 : key == (pack("no") | lower) ? 0 : -1;
+    case 3: return key == (pack("yes") | lower) ? 1 : key == (pack("off") | lower) ? 0 : -1;
+    case 4: return key == (pack("true") | lower) ? 1 : -1;
+    case 5: return key == (pack("false") | lower) ? 0 : -1;
+    default: return -1;
+    }
+}
+} // namespace detail
+
+} // namespace simplearg
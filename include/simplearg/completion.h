@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * completion.h - answers to shell completion queries
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/static_dispatcher.h>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <unistd.h>
+
+namespace simplearg {
+namespace detail {
+template<class D, typename = void>
+struct has_routes : std::false_type {};
+template<class D>
+struct has_routes<D, std::void_t<decltype(D::routes_begin(std::declval<typename D::node_type>()))>> : std::true_type {};
+
+// Calls put with names and aliases of the node starting with prefix, in sorted order
+template<class D, class Put>
+void completions(const D& dispatcher, typename D::node_type node, std::string_view prefix, Put&& put) {
+    auto starts = [prefix](std::string_view name) { return name.substr(0, prefix.size()) == prefix; };
+    if constexpr (has_routes<D>::value) {
+        auto end = D::routes_end(node);
+        auto i = std::lower_bound(D::routes_begin(node), end, prefix,
+            [](const auto& route, std::string_view name) { return route.name < name; });
+        for(; i != end && starts(i->name); ++i) if (!i->name.empty()) put(i->name);
+    } else {
+        std::vector<std::string_view> names {};
+        for(auto& p : dispatcher.level(node)) {
+            if (!p) continue;
+            const std::string_view name { p.name() };
+            if (!name.empty() && starts(name)) names.push_back(name);
+            split_aliases(p.aliases(), [&names, &starts](std::string_view alias) { if (starts(alias)) names.push_back(alias); });
+        }
+        std::sort(names.begin(), names.end());
+        for(auto name : names) put(name);
+    }
+}
+} // namespace detail
+
+// Answers a completion query without parsing: words are arguments typed so far, the last one is completed.
+// Preceding words select nested tables, names and aliases starting with the last word are written
+// to fd one per line, with a single write for any reply that fits the pipe
+template<class D>
+bool complete(const D& dispatcher, int count, const char* const words[], int fd = STDOUT_FILENO) {
+    auto node = dispatcher.root();
+    for(int i = 0; i + 1 < count; ++i) {
+        std::string_view word { words[i] };
+        const auto eq = word.find('=');
+        auto p = dispatcher.find(node, eq == word.npos ? word : word.substr(0, eq + 1));
+        if (p != nullptr && p->table() != nullptr) node = dispatcher.child(node, *p);
+    }
+    std::string_view prefix { count > 0 ? words[count - 1] : "" };
+    std::string_view groups {};
+    // dotted keys are completed segment by segment, --db.po with groups --db. and pool.
+    for(auto dot = prefix.find('.'); dot != prefix.npos; dot = prefix.find('.', groups.size())) {
+        auto group = dispatcher.find(node, prefix.substr(groups.size(), dot + 1 - groups.size()));
+        if (group == nullptr || group->table() == nullptr) break;
+        node = dispatcher.child(node, *group);
+        groups = prefix.substr(0, dot + 1);
+    }
+    std::string reply {};
+    detail::completions(dispatcher, node, prefix.substr(groups.size()), [&reply, groups](std::string_view name) {
+        ((reply += groups) += name) += '\n';
+    });
+    for(std::size_t written = 0; written < reply.size();) {
+        const auto got = ::write(fd, reply.data() + written, reply.size() - written);
+        if (got <= 0) return false;
+        written += static_cast<std::size_t>(got);
+    }
+    return true;
+}
+template<class Class, std::size_t Size>
+bool complete(const Parameters<Class, Size>& params, int count, const char* const words[], int fd = STDOUT_FILENO) {
+    return complete(Dispatcher<Class>{params}, count, words, fd);
+}
+
+} // namespace simplearg
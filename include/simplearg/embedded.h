@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * embedded.h - compile time tokenized embedded configuration
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#include <simplearg/str2argv.h>
+#include <array>
+#include <utility>
+
+namespace simplearg {
+
+// Tokenizes a string literal with str2argv rules at compile time.
+// Str must be a constexpr char array with static storage duration:
+//   static constexpr char defaults[] = "--port=80 --verbose";
+//   Arguments args = Embedded<defaults>::arguments();
+template<const auto& Str, char Comment = '#'>
+class Embedded {
+public:
+    static constexpr std::size_t count = count_tokens(Str, Comment);
+    static Arguments arguments() noexcept { return { static_cast<int>(count), values.data() }; }
+private:
+    static constexpr auto text = tokenize(Str, Comment);
+    static constexpr auto offsets = token_offsets<count>(Str, Comment);
+    template<std::size_t ... I>
+    static constexpr std::array<const char*, count> pointers(std::index_sequence<I...>) noexcept {
+        return {{ text.data() + offsets[I] ... }};
+    }
+public:
+    static constexpr std::array<const char*, count> values = pointers(std::make_index_sequence<count>{});
+};
+
+} // namespace simplearg
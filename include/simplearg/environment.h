@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * environment.h - environment variables index for parameter fallbacks
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace simplearg {
+
+// Indexes environment variables once, lookups are O(1)
+class Environment {
+public:
+    explicit Environment(std::string_view prefix = {}, char** env = environ) : prefix_ { prefix } {
+        for(; env != nullptr && *env != nullptr; ++env) {
+            std::string_view var { *env };
+            const auto eq = var.find('=');
+            if (eq != var.npos) variables_.emplace(var.substr(0, eq), *env + eq + 1);
+        }
+    }
+    const char* find(std::string_view name) const noexcept {
+        auto found = variables_.find(name);
+        return found == variables_.end() ? nullptr : found->second;
+    }
+    // Returns value of the variable bound to a parameter. Empty binding derives the variable name
+    // from the parameter name and the prefix: --max-conn= with prefix APP_ becomes APP_MAX_CONN.
+    // Names that do not fit the stack buffer are built on the heap
+    const char* find(const char* binding, std::string_view name) const {
+        if (binding == nullptr) return nullptr;
+        if (binding[0] != '\0') return find(binding);
+        while(!name.empty() && name.front() == '-') name.remove_prefix(1);
+        if (!name.empty() && name.back() == '=') name.remove_suffix(1);
+        if (name.empty()) return nullptr;
+        const std::size_t size = prefix_.size() + name.size();
+        char buffer[128];
+        std::string heap {};
+        char* variable = buffer;
+        if (size > sizeof(buffer)) {
+            heap.resize(size);
+            variable = heap.data();
+        }
+        char* out = variable + prefix_.copy(variable, prefix_.size());
+        for(auto chr : name)
+            *out++ = chr == '-' || chr == '.' ? '_' : chr >= 'a' && chr <= 'z' ? static_cast<char>(chr - 'a' + 'A') : chr;
+        return find({ variable, size });
+    }
+private:
+    std::string prefix_;
+    std::unordered_map<std::string_view, const char*> variables_ {};
+};
+
+} // namespace simplearg
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * file.h - file path value type with readahead
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace simplearg {
+
+// Path of a file to be read. Conversion opens the file and requests readahead of its content,
+// so that the I/O overlaps with the rest of parsing and initialization.
+// The descriptor is kept open for the program to use or release, a copy holds a duplicate of it
+class FilePath {
+public:
+    FilePath() noexcept = default;
+    FilePath(const FilePath& that) : path_ { that.path_ }, fd_ { duplicate(that.fd_) } {}
+    FilePath& operator=(const FilePath& that) {
+        if (this != &that) {
+            close();
+            path_ = that.path_;
+            fd_ = duplicate(that.fd_);
+        }
+        return *this;
+    }
+    FilePath(FilePath&& that) noexcept : path_ { std::move(that.path_) }, fd_ { std::exchange(that.fd_, -1) } {}
+    FilePath& operator=(FilePath&& that) noexcept {
+        if (this != &that) {
+            close();
+            path_ = std::move(that.path_);
+            fd_ = std::exchange(that.fd_, -1);
+        }
+        return *this;
+    }
+    ~FilePath() { close(); }
+
+    bool open(std::string_view path) {
+        close();
+        path_ = path;
+        fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) return false;
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_WILLNEED);
+        return true;
+    }
+    std::string_view path() const noexcept { return path_; }
+    int fd() const noexcept { return fd_; }
+    // Transfers ownership of the descriptor to the caller
+    int release() noexcept { return std::exchange(fd_, -1); }
+    explicit operator bool() const noexcept { return fd_ >= 0; }
+private:
+    void close() noexcept {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+    static int duplicate(int fd) noexcept { return fd >= 0 ? ::fcntl(fd, F_DUPFD_CLOEXEC, 0) : -1; }
+    std::string path_ {};
+    int fd_ { -1 };
+};
+
+inline bool from_arg(std::string_view str, FilePath& value) {
+    return !str.empty() && value.open(str);
+}
+
+constexpr const char* arg_expects(const FilePath&) noexcept { return "readable file"; }
+
+} // namespace simplearg
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * metrics.h - per parameter call counters and latency histograms
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace simplearg {
+
+// Counts calls and failures of each parameter, including nested ones, and keeps a histogram
+// of handler latencies in logarithmic buckets with four sub-buckets per power of two.
+// Passed to parse as a probe, may be shared by concurrent parse calls
+template<class Class>
+class Metrics {
+public:
+    using is_probe = void;
+    using clock = std::chrono::steady_clock;
+    static constexpr std::size_t buckets = 252;
+
+    struct Sample {
+        std::string_view name;
+        std::uint64_t hits;
+        std::uint64_t failures;
+        std::array<std::uint64_t, buckets> histogram;
+        // Upper bound in nanoseconds of the latency below which the quantile q of calls fall
+        std::uint64_t percentile(double q) const noexcept {
+            const auto total = static_cast<double>(hits);
+            std::uint64_t count {};
+            for(std::size_t i = 0; i < buckets; ++i) {
+                count += histogram[i];
+                if (count != 0 && static_cast<double>(count) >= q * total) return upper(i);
+            }
+            return 0;
+        }
+    };
+
+    template<std::size_t Size>
+    explicit Metrics(const Parameters<Class, Size>& params) {
+        add(params.data(), Size);
+        counters_ = std::make_unique<Counters[]>(parameters_.size());
+    }
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    clock::time_point start() const noexcept { return clock::now(); }
+    void stop(const Parameter<Class>& p, clock::time_point start, bool result) noexcept {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+        auto found = slots_.find(&p);
+        if (found == slots_.end()) return;
+        auto& counters = counters_[found->second];
+        counters.hits.fetch_add(1, std::memory_order_relaxed);
+        if (!result) counters.failures.fetch_add(1, std::memory_order_relaxed);
+        counters.histogram[bucket(static_cast<std::uint64_t>(elapsed))].fetch_add(1, std::memory_order_relaxed);
+    }
+    // Parameters that were called at least once
+    std::vector<Sample> snapshot() const {
+        std::vector<Sample> result {};
+        for(std::size_t i = 0; i < parameters_.size(); ++i) {
+            auto& counters = counters_[i];
+            const auto hits = counters.hits.load(std::memory_order_relaxed);
+            if (hits == 0) continue;
+            Sample sample { parameters_[i]->name(), hits, counters.failures.load(std::memory_order_relaxed), {} };
+            for(std::size_t b = 0; b < buckets; ++b) sample.histogram[b] = counters.histogram[b].load(std::memory_order_relaxed);
+            result.push_back(sample);
+        }
+        return result;
+    }
+    void reset() noexcept {
+        for(std::size_t i = 0; i < parameters_.size(); ++i) {
+            counters_[i].hits.store(0, std::memory_order_relaxed);
+            counters_[i].failures.store(0, std::memory_order_relaxed);
+            for(auto& b : counters_[i].histogram) b.store(0, std::memory_order_relaxed);
+        }
+    }
+    // Values below 4 have own buckets, above that each power of two is split in four
+    static constexpr std::size_t bucket(std::uint64_t nanoseconds) noexcept {
+        if (nanoseconds < 4) return static_cast<std::size_t>(nanoseconds);
+        std::size_t msb = 63;
+        while((nanoseconds >> msb) == 0) --msb;
+        return (msb - 1) * 4 + ((nanoseconds >> (msb - 2)) & 3);
+    }
+    static constexpr std::uint64_t upper(std::size_t bucket) noexcept {
+        if (bucket < 4) return bucket;
+        const std::size_t shift = bucket / 4 - 1;
+        return ((std::uint64_t { 4 } + bucket % 4 + 1) << shift) - 1;
+    }
+
+private:
+    struct Counters {
+        std::atomic<std::uint64_t> hits {};
+        std::atomic<std::uint64_t> failures {};
+        std::array<std::atomic<std::uint64_t>, buckets> histogram {};
+    };
+    void add(const Parameter<Class>* params, std::size_t size) {
+        for(std::size_t i = 0; i < size; ++i) {
+            if (!params[i] || slots_.count(&params[i]) != 0) continue;
+            slots_.emplace(&params[i], parameters_.size());
+            parameters_.push_back(&params[i]);
+            if (params[i].table() != nullptr) add(params[i].table(), params[i].table_size());
+        }
+    }
+
+    std::vector<const Parameter<Class>*> parameters_ {};
+    std::unordered_map<const Parameter<Class>*, std::size_t> slots_ {};
+    std::unique_ptr<Counters[]> counters_ {};
+};
+
+} // namespace simplearg
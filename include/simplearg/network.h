@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * network.h - network address and endpoint value types
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace simplearg {
+
+struct IPv4 {
+    std::array<std::uint8_t, 4> bytes {};
+};
+
+struct IPv6 {
+    std::array<std::uint8_t, 16> bytes {};
+};
+
+struct Port {
+    std::uint16_t value {};
+};
+
+// IPv4 address occupies first four bytes
+struct Address {
+    enum class Family : std::uint8_t { none, ipv4, ipv6 };
+    Family family {};
+    std::array<std::uint8_t, 16> bytes {};
+};
+
+// host:port, [ipv6]:port or :port, host is empty or a host name when address family is none
+struct Endpoint {
+    std::string_view host {};
+    Address address {};
+    std::uint16_t port {};
+};
+
+// address/prefix
+struct Cidr {
+    Address address {};
+    std::uint8_t prefix {};
+};
+
+namespace detail {
+// Parses decimal number with no leading zeros not exceeding max
+constexpr bool decimal(std::string_view str, unsigned max, unsigned& value) noexcept {
+    if (str.empty() || str.size() > 5 || (str[0] == '0' && str.size() > 1)) return false;
+    value = 0;
+    for(auto chr : str) {
+        if (chr < '0' || chr > '9') return false;
+        value = value * 10 + static_cast<unsigned>(chr - '0');
+    }
+    return value <= max;
+}
+constexpr int hexdigit(char chr) noexcept {
+    return chr >= '0' && chr <= '9' ? chr - '0'
+         : chr >= 'a' && chr <= 'f' ? chr - 'a' + 10
+         : chr >= 'A' && chr <= 'F' ? chr - 'A' + 10 : -1;
+}
+} // namespace detail
+
+constexpr bool from_arg(std::string_view str, IPv4& value) noexcept {
+    std::size_t octet = 0;
+    while(octet < 4) {
+        const auto dot = str.find('.');
+        unsigned number {};
+        if ((dot == str.npos) != (octet == 3)) return false;
+        if (!detail::decimal(str.substr(0, dot), 255, number)) return false;
+        value.bytes[octet++] = static_cast<std::uint8_t>(number);
+        str.remove_prefix(dot == str.npos ? str.size() : dot + 1);
+    }
+    return true;
+}
+
+// Scans groups in a single pass, an IPv4 tail is recognized by the dot following its first digits
+constexpr bool from_arg(std::string_view str, IPv6& value) noexcept {
+    std::uint8_t bytes[16] {};
+    constexpr std::size_t none = std::size_t(-1);
+    std::size_t count = 0;
+    std::size_t gap = none;
+    const char* chr = str.data();
+    const char* const end = chr + str.size();
+    if (end - chr >= 2 && chr[0] == ':' && chr[1] == ':') {
+        gap = 0;
+        chr += 2;
+    } else if (chr != end && *chr == ':') {
+        return false;
+    }
+    while(chr != end) {
+        const char* const group = chr;
+        unsigned number {};
+        for(int digit {}; chr != end && (digit = detail::hexdigit(*chr)) >= 0; ++chr)
+            number = number * 16 + static_cast<unsigned>(digit);
+        if (chr != end && *chr == '.') {
+            IPv4 ipv4 {};
+            if (count > 12 || !from_arg(std::string_view(group, static_cast<std::size_t>(end - group)), ipv4)) return false;
+            for(auto b : ipv4.bytes) bytes[count++] = b;
+            break;
+        }
+        if (chr == group || chr - group > 4 || count >= 16) return false;
+        bytes[count++] = static_cast<std::uint8_t>(number >> 8);
+        bytes[count++] = static_cast<std::uint8_t>(number);
+        if (chr == end) break;
+        if (*chr != ':' || ++chr == end) return false;
+        if (*chr == ':') {
+            if (gap != none || count >= 16) return false;
+            gap = count;
+            ++chr;
+        }
+    }
+    if (gap == none ? count != 16 : count >= 16) return false;
+    const std::size_t shift = gap == none ? 0 : 16 - count;
+    value.bytes = {};
+    for(std::size_t i = 0; i < count; ++i) value.bytes[i < gap ? i : i + shift] = bytes[i];
+    return true;
+}
+
+constexpr bool from_arg(std::string_view str, Port& value) noexcept {
+    unsigned number {};
+    if (!detail::decimal(str, 65535, number)) return false;
+    value.value = static_cast<std::uint16_t>(number);
+    return true;
+}
+
+constexpr bool from_arg(std::string_view str, Address& value) noexcept {
+    IPv4 ipv4 {};
+    IPv6 ipv6 {};
+    if (str.find(':') == str.npos) {
+        if (!from_arg(str, ipv4)) return false;
+        value = {};
+        value.family = Address::Family::ipv4;
+        for(std::size_t i = 0; i < 4; ++i) value.bytes[i] = ipv4.bytes[i];
+        return true;
+    }
+    if (!from_arg(str, ipv6)) return false;
+    value.family = Address::Family::ipv6;
+    value.bytes = ipv6.bytes;
+    return true;
+}
+
+constexpr bool from_arg(std::string_view str, Endpoint& value) noexcept {
+    std::string_view host {};
+    Port port {};
+    if (!str.empty() && str[0] == '[') {
+        const auto close = str.find("]:");
+        if (close == str.npos || !from_arg(str.substr(close + 2), port)) return false;
+        host = str.substr(1, close - 1);
+        if (host.find(':') == host.npos || !from_arg(host, value.address)) return false;
+    } else {
+        const auto colon = str.rfind(':');
+        if (colon == str.npos || str.find(':') != colon || !from_arg(str.substr(colon + 1), port)) return false;
+        host = str.substr(0, colon);
+        if (!from_arg(host, value.address)) {
+            if (host.size() > 253 || host.find("..") != host.npos || (!host.empty() && (host.front() == '.' || host.front() == '-'))) return false;
+            for(auto chr : host)
+                if (!((chr >= 'a' && chr <= 'z') || (chr >= 'A' && chr <= 'Z') || (chr >= '0' && chr <= '9') || chr == '-' || chr == '.'))
+                    return false;
+            value.address = {};
+        }
+    }
+    value.host = host;
+    value.port = port.value;
+    return true;
+}
+
+constexpr bool from_arg(std::string_view str, Cidr& value) noexcept {
+    const auto slash = str.find('/');
+    unsigned prefix {};
+    if (slash == str.npos || !from_arg(str.substr(0, slash), value.address)) return false;
+    if (!detail::decimal(str.substr(slash + 1), value.address.family == Address::Family::ipv4 ? 32 : 128, prefix)) return false;
+    value.prefix = static_cast<std::uint8_t>(prefix);
+    return true;
+}
+
+constexpr const char* arg_expects(const IPv4&) noexcept { return "IPv4 address"; }
+constexpr const char* arg_expects(const IPv6&) noexcept { return "IPv6 address"; }
+constexpr const char* arg_expects(const Address&) noexcept { return "IP address"; }
+constexpr const char* arg_expects(const Port&) noexcept { return "port number"; }
+constexpr const char* arg_expects(const Endpoint&) noexcept { return "host:port"; }
+constexpr const char* arg_expects(const Cidr&) noexcept { return "address/prefix"; }
+
+} // namespace simplearg
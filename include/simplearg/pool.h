@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * pool.h - thread pool for parallel handlers
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace simplearg {
+
+// Runs batches of independent tasks. Workers and the calling thread take tasks
+// from the shared batch cursor until it is exhausted, so a slow task does not
+// hold back the remaining ones
+class HandlerPool {
+public:
+    explicit HandlerPool(unsigned threads = std::thread::hardware_concurrency()) {
+        for(unsigned i = 1; i < threads; ++i) workers_.emplace_back([this] { work(); });
+    }
+    HandlerPool(const HandlerPool&) = delete;
+    HandlerPool& operator=(const HandlerPool&) = delete;
+    ~HandlerPool() {
+        {
+            std::lock_guard<std::mutex> lock { mutex_ };
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for(auto& w : workers_) w.join();
+    }
+    // Calls task(i) for each i in [0, count) and returns when all calls completed
+    void run(std::size_t count, const std::function<void(std::size_t)>& task) {
+        if (count == 0) return;
+        std::unique_lock<std::mutex> lock { mutex_ };
+        task_ = &task;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        done_ = 0;
+        ++batch_;
+        lock.unlock();
+        wake_.notify_all();
+        take(task, count);
+        lock.lock();
+        finished_.wait(lock, [this] { return done_ == count_ && active_ == 0; });
+        task_ = nullptr;
+    }
+    std::size_t size() const noexcept { return workers_.size() + 1; }
+private:
+    void work() {
+        std::size_t seen {};
+        std::unique_lock<std::mutex> lock { mutex_ };
+        for(;;) {
+            wake_.wait(lock, [this, &seen] { return stop_ || (batch_ != seen && task_ != nullptr); });
+            if (stop_) return;
+            seen = batch_;
+            auto task = task_;
+            auto count = count_;
+            ++active_;
+            lock.unlock();
+            take(*task, count);
+            lock.lock();
+            --active_;
+            if (done_ == count_ && active_ == 0) finished_.notify_all();
+        }
+    }
+    void take(const std::function<void(std::size_t)>& task, std::size_t count) {
+        std::size_t completed {};
+        for(auto i = next_.fetch_add(1); i < count; i = next_.fetch_add(1)) {
+            task(i);
+            ++completed;
+        }
+        std::lock_guard<std::mutex> lock { mutex_ };
+        done_ += completed;
+        if (done_ == count_ && active_ == 0) finished_.notify_all();
+    }
+    std::vector<std::thread> workers_ {};
+    std::mutex mutex_ {};
+    std::condition_variable wake_ {};
+    std::condition_variable finished_ {};
+    const std::function<void(std::size_t)>* task_ {};
+    std::size_t count_ {};
+    std::size_t done_ {};
+    std::size_t batch_ {};
+    unsigned active_ {};
+    std::atomic<std::size_t> next_ {};
+    bool stop_ {};
+};
+
+} // namespace simplearg
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * program.h - arguments compiled once for applying to many objects
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#include <simplearg/pool.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace simplearg {
+
+// Arguments parsed once into a sequence of handler calls with the values each call consumed.
+// Running the program calls the handlers directly, without matching names.
+// Handlers created with bind that no other handler follows are replayed by copying the member
+// converted at compile time, others convert their value again. Deferred handlers run last as in parse,
+// parallel ones run before them one after another, the pool of run() processes objects, not handlers
+template<class Class>
+class Program {
+public:
+    Program() = default;
+    Program(const Program&) = delete;
+    Program& operator=(const Program&) = delete;
+    // Parses args against a default constructed object, recording the calls
+    template<std::size_t Size>
+    bool compile(Arguments& args, const Parameters<Class, Size>& params) {
+        return compile(args, Dispatcher<Class>{params});
+    }
+    template<class D>
+    bool compile(Arguments& args, const D& dispatcher) {
+        steps_.clear();
+        errors_.clear();
+        storage_.clear();
+        tokens_.clear();
+        prototype_ = Class {};
+        std::vector<std::size_t> offsets {};
+        for(auto token = args.get(); !token.empty(); token = args.get()) {
+            offsets.push_back(storage_.size());
+            (storage_ += token) += '\0';
+        }
+        if (!args.errors().empty()) return error(args.errors());
+        for(auto offset : offsets) tokens_.push_back(storage_.data() + offset);
+        Arguments flat { static_cast<int>(tokens_.size()), tokens_.data() };
+        // visited right after the name is taken, the name ends values of the previous call,
+        // flags clustered in one argument share it
+        const bool result = flat.dispatch(prototype_, dispatcher,
+                                          [this, &flat](const Parameter<Class>* p, std::string_view name, std::size_t pos) {
+            const auto index = static_cast<std::size_t>(flat.values_ - tokens_.data()) - 1;
+            if (!steps_.empty()) steps_.back().end = std::max(index, steps_.back().begin);
+            steps_.push_back({ p, name, pos != 0 ? index : index + 1, pos, tokens_.size(), nullptr });
+        }, detail::no_pool);
+        if (!result) return error(flat.errors());
+        // parse runs deferred and parallel handlers after all other ones
+        std::stable_partition(steps_.begin(), steps_.end(), [](const Step& step) {
+            return step.parameter->execution() == Execution::immediate;
+        });
+        std::stable_partition(steps_.begin(), steps_.end(), [](const Step& step) {
+            return step.parameter->execution() != Execution::deferred;
+        });
+        // the prototype holds members as the last handler left them, which is the value of a bound member
+        // at its step only when no handler that may change the object follows
+        for(auto step = steps_.rbegin(); step != steps_.rend(); ++step) {
+            const auto& p = *step->parameter;
+            if (p.dispatcher() != nullptr) break;
+            if (p.handler() == nullptr) continue;
+            step->copier = detail::Copiers<Class>::find(p.handler());
+            if (step->copier == nullptr) break;
+        }
+        return true;
+    }
+    bool run(Class& obj) {
+        std::string errors {};
+        const bool result = replay(obj, errors);
+        if (!result) error(errors);
+        return result;
+    }
+    // Runs the program for each object in [begin, end), on the pool if given
+    template<class Iterator>
+    bool run(Iterator begin, Iterator end, HandlerPool* pool = nullptr) {
+        const auto count = static_cast<std::size_t>(end - begin);
+        std::vector<std::string> errors(count);
+        auto task = [this, &begin, &errors](std::size_t i) { replay(begin[i], errors[i]); };
+        if (pool != nullptr) pool->run(count, task);
+        else for(std::size_t i = 0; i < count; ++i) task(i);
+        bool result = true;
+        for(std::size_t i = 0; i < count; ++i) {
+            if (errors[i].empty()) continue;
+            error("object ", std::to_string(i), ": ", errors[i]);
+            result = false;
+        }
+        return result;
+    }
+    std::size_t size() const noexcept { return steps_.size(); }
+    std::string errors() {
+        std::string result { std::move(errors_) };
+        errors_.clear();
+        return result;
+    }
+
+private:
+    struct Step {
+        const Parameter<Class>* parameter;
+        std::string_view name;
+        std::size_t begin;  // values of the call are tokens [begin, end), the first one from skip
+        std::size_t skip;
+        std::size_t end;
+        typename detail::Copiers<Class>::copier_type copier;
+    };
+
+    bool replay(Class& obj, std::string& errors) const {
+        for(auto& step : steps_) {
+            if (step.copier != nullptr) {
+                step.copier(prototype_, obj);
+                continue;
+            }
+            Arguments args { static_cast<int>(step.end - step.begin), tokens_.data() + step.begin };
+            args.skip_ = step.skip;
+            if (!(*step.parameter)(obj, step.name, args)) {
+                errors = args.errors().empty() ? std::string { step.name } + " failed" : args.errors();
+                return false;
+            }
+        }
+        return true;
+    }
+    template<typename ... T>
+    bool error(T ... str) {
+        if (!errors_.empty()) errors_ += '\n';
+        ((errors_ += str), ...);
+        return false;
+    }
+
+    Class prototype_ {};
+    std::string storage_ {};
+    std::vector<const char*> tokens_ {};
+    std::vector<Step> steps_ {};
+    std::string errors_ {};
+};
+
+} // namespace simplearg
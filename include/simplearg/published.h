@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * published.h - versioned publication of parsed settings for concurrent readers
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace simplearg {
+
+// Holds the current settings instance, reload parses into a new instance and publishes it atomically.
+// Readers access settings through Reader, which revalidates its cached copy with one atomic load
+// and takes the slow path only after a reload. The instance is held in std::atomic<std::shared_ptr>
+// where the library provides it, otherwise std::atomic_load and std::atomic_store on shared_ptr
+// are used, which take a lock from a global pool in common implementations
+template<class Settings>
+class Published {
+public:
+    class Reader {
+    public:
+        explicit Reader(const Published& published) : published_ { published } { refresh(); }
+        const Settings& operator*() noexcept {
+            if (published_.version_.load(std::memory_order_acquire) != version_) refresh();
+            return *current_;
+        }
+        const Settings* operator->() noexcept { return &**this; }
+        std::uint64_t version() const noexcept { return version_; }
+    private:
+        void refresh() noexcept {
+            version_ = published_.version_.load(std::memory_order_acquire);
+            current_ = published_.load();
+        }
+        const Published& published_;
+        std::shared_ptr<const Settings> current_ {};
+        std::uint64_t version_ {};
+    };
+
+    explicit Published(Settings initial = {}) : current_ { std::make_shared<const Settings>(std::move(initial)) } {}
+    Published(const Published&) = delete;
+    Published& operator=(const Published&) = delete;
+
+    // Parses args into a copy of the current settings and publishes it on success
+    template<std::size_t Size>
+    bool reload(Arguments& args, const Parameters<Settings, Size>& params) {
+        return reload(args, Dispatcher<Settings>{params});
+    }
+    bool reload(Arguments& args, const Dispatcher<Settings>& dispatcher) {
+        std::lock_guard<std::mutex> lock { reload_ };
+        auto next = std::make_shared<Settings>(*load());
+        if (!args.parse(*next, dispatcher)) return false;
+        publish(std::move(next));
+        return true;
+    }
+    void publish(std::shared_ptr<const Settings> next) noexcept {
+#if defined(__cpp_lib_atomic_shared_ptr) && (__cpp_lib_atomic_shared_ptr >= 201711L)
+        current_.store(std::move(next), std::memory_order_release);
+#else
+        std::atomic_store_explicit(&current_, std::move(next), std::memory_order_release);
+#endif
+        version_.fetch_add(1, std::memory_order_release);
+    }
+    std::shared_ptr<const Settings> load() const noexcept {
+#if defined(__cpp_lib_atomic_shared_ptr) && (__cpp_lib_atomic_shared_ptr >= 201711L)
+        return current_.load(std::memory_order_acquire);
+#else
+        return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+#endif
+    }
+    Reader reader() const { return Reader { *this }; }
+    std::uint64_t version() const noexcept { return version_.load(std::memory_order_acquire); }
+private:
+#if defined(__cpp_lib_atomic_shared_ptr) && (__cpp_lib_atomic_shared_ptr >= 201711L)
+    std::atomic<std::shared_ptr<const Settings>> current_;
+#else
+    std::shared_ptr<const Settings> current_;
+#endif
+    std::atomic<std::uint64_t> version_ {};
+    std::mutex reload_ {};
+};
+
+} // namespace simplearg
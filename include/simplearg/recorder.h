@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * recorder.h - recording of parsed command streams and their offline replay
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace simplearg {
+
+// Log layout: magic, then records of Record header followed by tokens and names of
+// matched parameters, all NUL terminated
+struct Recording {
+    struct Record {
+        std::uint64_t time;     // nanoseconds since the recorder was created
+        std::uint32_t tokens;
+        std::uint32_t matched;
+        std::uint32_t size;     // bytes of tokens and names
+        std::uint32_t reserved;
+    };
+    static constexpr char magic[8] = "SARGREC";
+};
+
+namespace detail {
+// Probe collecting names of matched parameters
+class Matches {
+public:
+    using is_probe = void;
+    int start() const noexcept { return 0; }
+    template<class Class>
+    void stop(const Parameter<Class>& p, int, bool) {
+        (names_ += p.name()) += '\0';
+        ++count_;
+    }
+    std::string_view names() const noexcept { return names_; }
+    std::uint32_t count() const noexcept { return count_; }
+    void clear() noexcept {
+        names_.clear();
+        count_ = 0;
+    }
+private:
+    std::string names_ {};
+    std::uint32_t count_ {};
+};
+} // namespace detail
+
+// Parses arguments and appends them, with the time and the matched parameters, to a log.
+// Records are buffered and written in blocks, may be used from several threads
+class Recorder {
+public:
+    explicit Recorder(const std::string& path, std::size_t buffer = 64 * 1024)
+      : fd_ { ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) }, limit_ { buffer } {
+        if (fd_ < 0) errors_ = "cannot create '" + path + '\'';
+        else buffer_.append(Recording::magic, sizeof(Recording::magic));
+    }
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+    ~Recorder() {
+        flush();
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    // Records the remaining arguments as they are in argv, response files as @file arguments,
+    // and parameters matched by immediate, deferred and parallel calls
+    template<class Class, class D>
+    bool parse(Arguments& args, Class& obj, const D& dispatcher) {
+        const auto time = std::chrono::steady_clock::now() - start_;
+        const Range first { args.values_, args.count_ > 0 ? args.count_ : 0, args.skip_ };
+        std::vector<Range> frames {};
+        for(auto f = args.frames_.rbegin(); f != args.frames_.rend(); ++f) frames.push_back({ f->values, f->count, 0 });
+        detail::Matches matches {};
+        const bool result = args.parse(obj, dispatcher, matches);
+        std::uint32_t tokens {};
+        std::size_t size { matches.names().size() };
+        auto measure = [&tokens, &size](const Range& r) {
+            for(int i = 0; i < r.count; ++i, ++tokens) size += std::strlen(r.values[i] + (i == 0 ? r.skip : 0)) + 1;
+        };
+        measure(first);
+        for(auto& r : frames) measure(r);
+        const Recording::Record record {
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count()),
+            tokens, matches.count(), static_cast<std::uint32_t>(size), 0 };
+        std::lock_guard<std::mutex> lock { mutex_ };
+        buffer_.append(reinterpret_cast<const char*>(&record), sizeof(record));
+        auto append = [this](const Range& r) {
+            for(int i = 0; i < r.count; ++i) buffer_.append(r.values[i] + (i == 0 ? r.skip : 0)) += '\0';
+        };
+        append(first);
+        for(auto& r : frames) append(r);
+        buffer_ += matches.names();
+        if (buffer_.size() >= limit_) write();
+        return result;
+    }
+    template<class Class, std::size_t Size>
+    bool parse(Arguments& args, Class& obj, const Parameters<Class, Size>& params) {
+        return parse(args, obj, Dispatcher<Class>{params});
+    }
+    bool flush() {
+        std::lock_guard<std::mutex> lock { mutex_ };
+        return write();
+    }
+    const std::string& errors() const noexcept { return errors_; }
+
+private:
+    struct Range {
+        const char* const* values;
+        int count;
+        std::size_t skip;
+    };
+    bool write() {
+        if (fd_ < 0) return false;
+        for(std::size_t written = 0; written < buffer_.size();) {
+            const auto got = ::write(fd_, buffer_.data() + written, buffer_.size() - written);
+            if (got <= 0) {
+                errors_ = "cannot write the recording";
+                buffer_.clear();
+                return false;
+            }
+            written += static_cast<std::size_t>(got);
+        }
+        buffer_.clear();
+        return true;
+    }
+
+    int fd_;
+    std::size_t limit_;
+    std::chrono::steady_clock::time_point start_ { std::chrono::steady_clock::now() };
+    std::mutex mutex_ {};
+    std::string buffer_ {};
+    std::string errors_ {};
+};
+
+// Drives a recorded stream through a parameters table and measures it
+class Replay {
+public:
+    struct Stats {
+        std::size_t records;
+        std::size_t failures;   // parse returned false
+        std::size_t mismatches; // matched parameters differ from the recorded ones
+        double seconds;
+        std::uint64_t p50;      // parse latency, nanoseconds
+        std::uint64_t p99;
+        std::uint64_t p999;
+        std::uint64_t max;
+    };
+
+    Replay() = default;
+    Replay(const Replay&) = delete;
+    Replay& operator=(const Replay&) = delete;
+
+    bool load(const std::string& path) {
+        data_.clear();
+        records_.clear();
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return error("cannot read '", path, '\'');
+        char buffer[64 * 1024];
+        for(;;) {
+            const auto got = ::read(fd, buffer, sizeof(buffer));
+            if (got <= 0) {
+                ::close(fd);
+                if (got < 0) return error("cannot read '", path, '\'');
+                break;
+            }
+            data_.append(buffer, static_cast<std::size_t>(got));
+        }
+        if (data_.compare(0, sizeof(Recording::magic), Recording::magic, sizeof(Recording::magic)) != 0)
+            return error("'", path, "' is not a recording");
+        for(std::size_t pos = sizeof(Recording::magic); pos < data_.size();) {
+            Recording::Record record {};
+            if (data_.size() - pos < sizeof(record)) return error("'", path, "' is truncated");
+            std::memcpy(&record, data_.data() + pos, sizeof(record));
+            pos += sizeof(record);
+            if (data_.size() - pos < record.size) return error("'", path, "' is truncated");
+            Entry entry { record.time, {}, { data_.data() + pos, record.size }, record.matched };
+            const char* token = data_.data() + pos;
+            const char* end = token + record.size;
+            for(std::uint32_t i = 0; i < record.tokens; ++i, token += std::strlen(token) + 1) {
+                if (token >= end || std::memchr(token, '\0', static_cast<std::size_t>(end - token)) == nullptr)
+                    return error("'", path, "' is corrupted");
+                entry.tokens.push_back(token);
+            }
+            entry.names.remove_prefix(static_cast<std::size_t>(token - data_.data()) - pos);
+            records_.push_back(std::move(entry));
+            pos += record.size;
+        }
+        return true;
+    }
+    std::size_t size() const noexcept { return records_.size(); }
+
+    // Parses every record with obj, at full speed or keeping the recorded intervals
+    template<class Class, class D>
+    Stats run(Class& obj, const D& dispatcher, bool paced = false) {
+        Stats stats {};
+        std::vector<std::uint64_t> latencies {};
+        latencies.reserve(records_.size());
+        detail::Matches matches {};
+        const auto start = std::chrono::steady_clock::now();
+        for(auto& record : records_) {
+            if (paced) std::this_thread::sleep_until(start + std::chrono::nanoseconds(record.time - records_.front().time));
+            Arguments args { static_cast<int>(record.tokens.size()), record.tokens.data() };
+            matches.clear();
+            const auto begin = std::chrono::steady_clock::now();
+            const bool result = args.parse(obj, dispatcher, matches);
+            latencies.push_back(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count()));
+            if (!result) ++stats.failures;
+            if (matches.count() != record.matched || matches.names() != record.names) ++stats.mismatches;
+        }
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats.records = records_.size();
+        if (latencies.empty()) return stats;
+        std::sort(latencies.begin(), latencies.end());
+        auto at = [&latencies](double q) { return latencies[static_cast<std::size_t>(q * static_cast<double>(latencies.size() - 1))]; };
+        stats.p50 = at(0.5);
+        stats.p99 = at(0.99);
+        stats.p999 = at(0.999);
+        stats.max = latencies.back();
+        return stats;
+    }
+    template<class Class, std::size_t Size>
+    Stats run(Class& obj, const Parameters<Class, Size>& params, bool paced = false) {
+        return run(obj, Dispatcher<Class>{params}, paced);
+    }
+    const std::string& errors() const noexcept { return errors_; }
+
+private:
+    struct Entry {
+        std::uint64_t time;
+        std::vector<const char*> tokens;
+        std::string_view names;
+        std::uint32_t matched;
+    };
+    template<typename ... T>
+    bool error(T ... str) {
+        errors_.clear();
+        ((errors_ += str), ...);
+        return false;
+    }
+
+    std::string data_ {};
+    std::vector<Entry> records_ {};
+    std::string errors_ {};
+};
+
+} // namespace simplearg
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * response.h - response files (@file) loader for SimpleArg
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#include <simplearg/str2argv.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace simplearg {
+
+// Maps response files into memory, tokenizes them with str2argv rules
+// and keeps the tokens for subsequent references to the same file
+class ResponseFiles final : public ResponseLoader {
+public:
+    class File : public ResponseFile {
+    public:
+        File() = default;
+        File(const File&) = delete;
+        File& operator=(const File&) = delete;
+        ~File() { if (data_ != nullptr) munmap(data_, size_); }
+    private:
+        friend class ResponseFiles;
+        void* data_ {};
+        std::size_t size_ {};
+        std::string buffer_ {};
+    };
+
+    explicit ResponseFiles(char comment = '#') : comment_ { comment } {}
+    ResponseFiles(const ResponseFiles&) = delete;
+    ResponseFiles& operator=(const ResponseFiles&) = delete;
+
+    // Returns tokenized file or nullptr with error description appended to errors
+    File* load(const char* path, std::string& errors) override {
+        auto [entry, inserted] = files_.try_emplace(path);
+        if (!inserted) return &entry->second;
+        if (open(path, entry->second)) return &entry->second;
+        errors += "cannot read response file '";
+        errors += path;
+        errors += '\'';
+        files_.erase(entry);
+        return nullptr;
+    }
+private:
+    bool open(const char* path, File& file) {
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st {};
+        bool result = fstat(fd, &st) == 0;
+        if (result) {
+            file.device_ = st.st_dev;
+            file.inode_ = st.st_ino;
+            result = tokenize(fd, static_cast<std::size_t>(st.st_size), file);
+        }
+        ::close(fd);
+        return result;
+    }
+    bool tokenize(int fd, std::size_t size, File& file) {
+        if (size == 0) return true;
+        // the tail of the last page is zero filled and terminates the last token,
+        // files of exact page size have no such tail and are read into a buffer
+        if (size % static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) != 0) {
+            void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                file.data_ = data;
+                file.size_ = size;
+                auto begin = static_cast<char*>(data);
+                file.tokens_ = str2argv(begin, begin + size, comment_);
+                return true;
+            }
+        }
+        file.buffer_.resize(size);
+        for(std::size_t pos = 0; pos < size; ) {
+            const auto got = ::read(fd, file.buffer_.data() + pos, size - pos);
+            if (got <= 0) return false;
+            pos += static_cast<std::size_t>(got);
+        }
+        file.tokens_ = str2argv(file.buffer_, comment_);
+        return true;
+    }
+    char comment_;
+    std::unordered_map<std::string, File> files_ {};
+};
+
+} // namespace simplearg
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * script.h - pipelined executor of command scripts
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#include <simplearg/str2argv.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace simplearg {
+
+// Executes a script line by line. A producer thread reads and tokenizes batches of upcoming lines
+// into a ring buffer while the calling thread dispatches the current ones, in order of lines.
+// Execution stops at the first failed line. Input other than a regular file, such as a pipe,
+// is dispatched as soon as a complete line arrives, and a producer waiting for it is woken on failure
+template<class Class>
+class Script {
+public:
+    struct Stats {
+        std::size_t lines;
+        std::size_t tokens;
+        std::size_t bytes;
+        std::size_t producer_stalls; // ring was full
+        std::size_t consumer_stalls; // ring was empty
+        double seconds;
+    };
+
+    template<std::size_t Size>
+    Script(Class& obj, const Parameters<Class, Size>& params, std::size_t batches = 8, std::size_t batch_size = 64 * 1024,
+           char comment = '#')
+      : obj_ { obj }, dispatcher_ { params }, ring_(batches < 2 ? 2 : batches), batch_size_ { batch_size }, comment_ { comment } {}
+    Script(const Script&) = delete;
+    Script& operator=(const Script&) = delete;
+
+    bool run(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return error("cannot read '", path, '\'');
+        const bool result = run(fd, path);
+        ::close(fd);
+        return result;
+    }
+    // Executes lines read from fd until end of file, name prefixes line numbers in errors
+    bool run(int fd, std::string_view name = "script") {
+        const auto start = std::chrono::steady_clock::now();
+        name_ = name;
+        stats_ = {};
+        producer_stalls_ = consumer_stalls_ = 0;
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        stop_.store(false, std::memory_order_relaxed);
+        struct stat st {};
+        int wake[2] = { -1, -1 };
+        const bool regular = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+        if (!regular && ::pipe2(wake, O_CLOEXEC) != 0) return error("cannot read '", name_, '\'');
+        std::thread producer { [this, fd, cancel = wake[0]] { produce(fd, cancel); } };
+        const bool result = consume();
+        stop_.store(true, std::memory_order_release);
+        if (!regular) {
+            [[maybe_unused]] const auto woken = ::write(wake[1], "", 1);
+        }
+        producer.join();
+        for(auto w : wake) if (w >= 0) ::close(w);
+        stats_.producer_stalls = producer_stalls_;
+        stats_.consumer_stalls = consumer_stalls_;
+        stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+    const Stats& stats() const noexcept { return stats_; }
+    std::string errors() {
+        std::string result { std::move(errors_) };
+        errors_.clear();
+        return result;
+    }
+
+private:
+    // Lines of a batch are tokenized in place, ends[i] is the end of tokens of i-th non empty line
+    struct Batch {
+        std::string text;
+        std::vector<char*> tokens;
+        std::vector<std::size_t> ends;
+        std::vector<std::size_t> numbers;
+        bool last;
+        bool failed;
+    };
+
+    // cancel is the read end of a pipe written when the consumer stops, -1 for regular files
+    void produce(int fd, int cancel) {
+        std::string carry {};
+        std::size_t number {};
+        for(bool eof = false; !eof;) {
+            const auto head = head_.load(std::memory_order_relaxed);
+            if (!wait([this, head] { return head - tail_.load(std::memory_order_acquire) < ring_.size(); }, producer_stalls_))
+                return;
+            auto& batch = ring_[head % ring_.size()];
+            batch.text.swap(carry);
+            batch.failed = false;
+            std::size_t eol = batch.text.rfind('\n');
+            while(!eof && (eol == batch.text.npos || (cancel < 0 && batch.text.size() < batch_size_))) {
+                if (cancel >= 0 && !readable(fd, cancel)) return;
+                const auto size = batch.text.size();
+                batch.text.resize(size + batch_size_);
+                const auto got = ::read(fd, batch.text.data() + size, batch_size_);
+                batch.text.resize(size + static_cast<std::size_t>(got > 0 ? got : 0));
+                if (got <= 0) {
+                    eof = true;
+                    batch.failed = got < 0;
+                } else if (eol == batch.text.npos) {
+                    eol = batch.text.rfind('\n');
+                }
+            }
+            if (eof) {
+                if (!batch.text.empty() && batch.text.back() != '\n') batch.text += '\n';
+                carry.clear();
+            } else {
+                eol = batch.text.rfind('\n');
+                carry.assign(batch.text, eol + 1);
+                batch.text.resize(eol + 1);
+            }
+            tokenize(batch, number);
+            batch.last = eof;
+            head_.store(head + 1, std::memory_order_release);
+        }
+    }
+    // Waits until fd has input or is closed, returns false when cancelled
+    static bool readable(int fd, int cancel) {
+        pollfd fds[2] = { { fd, POLLIN, 0 }, { cancel, POLLIN, 0 } };
+        while(::poll(fds, 2, -1) < 0) if (errno != EINTR) return true;
+        return fds[1].revents == 0;
+    }
+    void tokenize(Batch& batch, std::size_t& number) {
+        using tokenizer = detail::tokenizer;
+        batch.tokens.clear();
+        batch.ends.clear();
+        batch.numbers.clear();
+        tokenizer::state_t state {};
+        for(auto& chr : batch.text) {
+            const auto symbol = tokenizer::symbol(chr, comment_);
+            if (symbol != tokenizer::symbol_t::token) chr = '\0';
+            state = tokenizer::next(state, symbol);
+            if (state == tokenizer::state_t::start) batch.tokens.push_back(&chr);
+            if (symbol != tokenizer::symbol_t::eol) continue;
+            ++number;
+            if (batch.tokens.size() == (batch.ends.empty() ? 0 : batch.ends.back())) continue;
+            batch.ends.push_back(batch.tokens.size());
+            batch.numbers.push_back(number);
+        }
+    }
+    bool consume() {
+        for(;;) {
+            const auto tail = tail_.load(std::memory_order_relaxed);
+            wait([this, tail] { return head_.load(std::memory_order_acquire) != tail; }, consumer_stalls_);
+            auto& batch = ring_[tail % ring_.size()];
+            if (batch.failed) return error("cannot read '", name_, '\'');
+            std::size_t begin {};
+            for(std::size_t i = 0; i < batch.ends.size(); ++i) {
+                Arguments args { static_cast<int>(batch.ends[i] - begin), batch.tokens.data() + begin };
+                if (!args.parse(obj_, dispatcher_))
+                    return error(name_, ':', std::to_string(batch.numbers[i]), ": ", args.errors());
+                begin = batch.ends[i];
+            }
+            stats_.lines += batch.numbers.size();
+            stats_.tokens += batch.tokens.size();
+            stats_.bytes += batch.text.size();
+            const bool last = batch.last;
+            tail_.store(tail + 1, std::memory_order_release);
+            if (last) return true;
+        }
+    }
+    // Spins briefly, then yields until ready, counts the waits. Returns false when stopped
+    template<class Ready>
+    bool wait(Ready&& ready, std::size_t& stalls) {
+        if (ready()) return true;
+        ++stalls;
+        for(unsigned spin = 0; !ready(); ++spin) {
+            if (stop_.load(std::memory_order_acquire)) return false;
+            if (spin > 64) std::this_thread::yield();
+        }
+        return true;
+    }
+    template<typename ... T>
+    bool error(T ... str) {
+        if (!errors_.empty()) errors_ += '\n';
+        ((errors_ += str), ...);
+        return false;
+    }
+
+    Class& obj_;
+    Dispatcher<Class> dispatcher_;
+    std::vector<Batch> ring_;
+    std::size_t batch_size_;
+    char comment_;
+    std::string name_ {};
+    std::string errors_ {};
+    Stats stats_ {};
+    std::size_t producer_stalls_ {};
+    std::size_t consumer_stalls_ {};
+    alignas(64) std::atomic<std::size_t> head_ {};
+    alignas(64) std::atomic<std::size_t> tail_ {};
+    std::atomic<bool> stop_ {};
+};
+
+} // namespace simplearg
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * snapshot.h - pre-tokenized binary snapshots of configuration files
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#include <simplearg/str2argv.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace simplearg {
+
+// Snapshot file layout: Header, uint32_t offsets[count], NUL terminated tokens
+// The snapshot is keyed by size, modification time and hash of the source.
+// load checks only size and modification time, verify reads the source and checks the hash
+class Snapshot {
+public:
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t count;
+        std::uint64_t size;
+        std::int64_t mtime_sec;
+        std::int64_t mtime_nsec;
+        std::uint64_t hash;
+        std::uint64_t data_size;
+    };
+    static constexpr char magic[8] = "SARGSNP";
+    static constexpr std::uint32_t version = 1;
+
+    Snapshot() = default;
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+    ~Snapshot() { unmap(); }
+
+    static std::string path(const char* source) { return std::string { source } + ".argv"; }
+
+    static std::uint64_t hash(std::string_view data) noexcept {
+        std::uint64_t result = 14695981039346656037ull;
+        for(auto chr : data) {
+            result ^= static_cast<unsigned char>(chr);
+            result *= 1099511628211ull;
+        }
+        return result;
+    }
+
+    // Tokenizes source and writes its snapshot next to it
+    static bool make(const char* source, std::string& errors, char comment = '#') {
+        std::string content {};
+        struct stat st {};
+        if (!read(source, content, st)) return error(errors, "cannot read '", source);
+        Header header {};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        key(header, st);
+        header.hash = hash(content);
+        const auto tokens = str2argv(content, comment);
+        std::vector<std::uint32_t> offsets {};
+        std::string data {};
+        offsets.reserve(tokens.size());
+        for(auto token : tokens) {
+            offsets.push_back(static_cast<std::uint32_t>(data.size()));
+            data.append(token, std::strlen(token) + 1);
+        }
+        header.count = static_cast<std::uint32_t>(offsets.size());
+        header.data_size = data.size();
+        const auto target = path(source);
+        const auto temp = target + ".tmp";
+        const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) return error(errors, "cannot create '", temp.c_str());
+        bool result = write(fd, &header, sizeof(header))
+                   && write(fd, offsets.data(), offsets.size() * sizeof(offsets[0]))
+                   && write(fd, data.data(), data.size());
+        result = ::close(fd) == 0 && result;
+        if (result && ::rename(temp.c_str(), target.c_str()) == 0) return true;
+        ::unlink(temp.c_str());
+        return error(errors, "cannot write '", target.c_str());
+    }
+
+    // Maps snapshot of source if it matches size and modification time of the source,
+    // a source rewritten within the timestamp granularity with the same size is not detected
+    bool load(const char* source, std::string& errors) {
+        unmap();
+        struct stat st {};
+        if (::stat(source, &st) != 0) return error(errors, "cannot stat '", source);
+        const auto target = path(source);
+        const int fd = ::open(target.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return error(errors, "cannot open '", target.c_str());
+        struct stat sst {};
+        if (fstat(fd, &sst) == 0 && static_cast<std::size_t>(sst.st_size) >= sizeof(Header)) {
+            size_ = static_cast<std::size_t>(sst.st_size);
+            data_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (data_ == MAP_FAILED) data_ = nullptr;
+        }
+        ::close(fd);
+        if (data_ == nullptr || !valid()) {
+            unmap();
+            return error(errors, "invalid snapshot '", target.c_str());
+        }
+        Header expected {};
+        key(expected, st);
+        if (header().size != expected.size || header().mtime_sec != expected.mtime_sec
+         || header().mtime_nsec != expected.mtime_nsec) {
+            unmap();
+            return error(errors, "outdated snapshot '", target.c_str());
+        }
+        const auto offsets = reinterpret_cast<const std::uint32_t*>(&header() + 1);
+        const auto tokens = reinterpret_cast<char*>(const_cast<std::uint32_t*>(offsets + header().count));
+        values_.resize(header().count);
+        for(std::uint32_t i = 0; i < header().count; ++i) values_[i] = tokens + offsets[i];
+        return true;
+    }
+
+    // Checks that the loaded snapshot matches content of the source
+    bool verify(const char* source, std::string& errors) const {
+        std::string content {};
+        struct stat st {};
+        if (data_ == nullptr) return error(errors, "no snapshot for '", source);
+        if (!read(source, content, st)) return error(errors, "cannot read '", source);
+        if (hash(content) != header().hash) return error(errors, "hash mismatch for '", source);
+        return true;
+    }
+
+    Arguments arguments() noexcept { return { static_cast<int>(values_.size()), values_.data() }; }
+    std::size_t size() const noexcept { return values_.size(); }
+    explicit operator bool() const noexcept { return data_ != nullptr; }
+
+private:
+    const Header& header() const noexcept { return *static_cast<const Header*>(data_); }
+    bool valid() const noexcept {
+        if (std::memcmp(header().magic, magic, sizeof(magic)) != 0 || header().version != version) return false;
+        const std::uint64_t need = sizeof(Header) + std::uint64_t { header().count } * sizeof(std::uint32_t) + header().data_size;
+        if (need != size_) return false;
+        const auto offsets = reinterpret_cast<const std::uint32_t*>(&header() + 1);
+        const auto tokens = reinterpret_cast<const char*>(offsets + header().count);
+        if (header().data_size != 0 && tokens[header().data_size - 1] != '\0') return false;
+        for(std::uint32_t i = 0; i < header().count; ++i)
+            if (offsets[i] >= header().data_size) return false;
+        return true;
+    }
+    void unmap() noexcept {
+        if (data_ != nullptr) munmap(data_, size_);
+        data_ = nullptr;
+        size_ = 0;
+        values_.clear();
+    }
+    static void key(Header& header, const struct stat& st) noexcept {
+        header.size = static_cast<std::uint64_t>(st.st_size);
+        header.mtime_sec = st.st_mtim.tv_sec;
+        header.mtime_nsec = st.st_mtim.tv_nsec;
+    }
+    static bool read(const char* source, std::string& content, struct stat& st) {
+        const int fd = ::open(source, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        bool result = fstat(fd, &st) == 0;
+        if (result) content.resize(static_cast<std::size_t>(st.st_size));
+        for(std::size_t pos = 0; result && pos < content.size(); ) {
+            const auto got = ::read(fd, content.data() + pos, content.size() - pos);
+            result = got > 0;
+            if (result) pos += static_cast<std::size_t>(got);
+        }
+        ::close(fd);
+        return result;
+    }
+    static bool write(int fd, const void* data, std::size_t size) {
+        auto ptr = static_cast<const char*>(data);
+        while(size > 0) {
+            const auto put = ::write(fd, ptr, size);
+            if (put <= 0) return false;
+            ptr += put;
+            size -= static_cast<std::size_t>(put);
+        }
+        return true;
+    }
+    static bool error(std::string& errors, const char* what, const char* name) {
+        ((errors += what) += name) += '\'';
+        return false;
+    }
+    void* data_ {};
+    std::size_t size_ {};
+    std::vector<char*> values_ {};
+};
+
+} // namespace simplearg
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * static_dispatcher.h - dispatch structure for nested parameter tables built at compile time
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#include <array>
+#include <string_view>
+#include <type_traits>
+
+namespace simplearg {
+namespace detail {
+
+template<class P>
+struct Route {
+    std::string_view name;
+    const P* parameter;
+};
+
+template<class P>
+struct RouteNode {
+    const P* begin;
+    std::size_t size;
+    std::size_t first;  // routes of the node are [first, last)
+    std::size_t last;
+    std::size_t offset; // offset of the node parameters in children
+};
+
+template<class P, std::size_t Nodes, std::size_t Routes, std::size_t Params>
+struct RouteTable {
+    std::array<RouteNode<P>, Nodes> nodes;
+    std::array<Route<P>, Routes> routes;
+    std::array<std::size_t, Params> children;
+};
+
+template<class Put>
+constexpr void split_aliases(const char* aliases, Put&& put) {
+    if (aliases == nullptr) return;
+    std::string_view current { aliases };
+    while(!current.empty()) {
+        const auto space = current.find(' ');
+        const auto alias = current.substr(0, space);
+        if (!alias.empty()) put(alias);
+        current.remove_prefix(space == current.npos ? current.size() : space + 1);
+    }
+}
+
+template<class P>
+constexpr std::size_t count_nodes(const P* params, std::size_t size) {
+    std::size_t result = 1;
+    for(std::size_t i = 0; i < size; ++i)
+        if (params[i] && params[i].table() != nullptr) result += count_nodes(params[i].table(), params[i].table_size());
+    return result;
+}
+
+template<class P>
+constexpr std::size_t count_routes(const P* params, std::size_t size) {
+    std::size_t result = 0;
+    for(std::size_t i = 0; i < size; ++i) {
+        if (!params[i]) continue;
+        ++result;
+        split_aliases(params[i].aliases(), [&result](std::string_view) { ++result; });
+        if (params[i].table() != nullptr) result += count_routes(params[i].table(), params[i].table_size());
+    }
+    return result;
+}
+
+template<class P>
+constexpr std::size_t count_params(const P* params, std::size_t size) {
+    std::size_t result = size;
+    for(std::size_t i = 0; i < size; ++i)
+        if (params[i] && params[i].table() != nullptr) result += count_params(params[i].table(), params[i].table_size());
+    return result;
+}
+
+// Orders routes by name, routes of the same name by reverse declaration of their parameters,
+// so that the last declared one is found, as with Dispatcher
+template<class P>
+constexpr bool before(const Route<P>& a, const Route<P>& b) noexcept {
+    return a.name < b.name || (a.name == b.name && a.parameter > b.parameter);
+}
+
+template<class P, std::size_t Routes>
+constexpr void sift(std::array<Route<P>, Routes>& routes, std::size_t first, std::size_t root, std::size_t size) noexcept {
+    for(auto child = 2 * root + 1; child < size; root = child, child = 2 * root + 1) {
+        if (child + 1 < size && before(routes[first + child], routes[first + child + 1])) ++child;
+        if (!before(routes[first + root], routes[first + child])) return;
+        const auto route = routes[first + root];
+        routes[first + root] = routes[first + child];
+        routes[first + child] = route;
+    }
+}
+
+// Heap sort of routes [first, last), within limits of constant evaluation for tables of thousands of names
+template<class P, std::size_t Routes>
+constexpr void sort_routes(std::array<Route<P>, Routes>& routes, std::size_t first, std::size_t last) noexcept {
+    const auto size = last - first;
+    for(auto i = size / 2; i-- > 0;) sift(routes, first, i, size);
+    for(auto end = size; end > 1; --end) {
+        const auto route = routes[first];
+        routes[first] = routes[first + end - 1];
+        routes[first + end - 1] = route;
+        sift(routes, first, 0, end - 1);
+    }
+}
+
+// Numbers nested tables breadth first and sorts routes of each table by name
+template<class P, std::size_t Nodes, std::size_t Routes, std::size_t Params>
+constexpr RouteTable<P, Nodes, Routes, Params> build_routes(const P* root, std::size_t size) {
+    RouteTable<P, Nodes, Routes, Params> table {};
+    table.nodes[0] = { root, size, 0, 0, 0 };
+    std::size_t nodes = 1, routes = 0, params = size;
+    for(std::size_t n = 0; n < nodes; ++n) {
+        auto& node = table.nodes[n];
+        node.first = routes;
+        for(std::size_t i = 0; i < node.size; ++i) {
+            const P& p = node.begin[i];
+            if (!p) continue;
+            table.routes[routes++] = { p.name(), &p };
+            split_aliases(p.aliases(), [&table, &routes, &p](std::string_view alias) {
+                table.routes[routes++] = { alias, &p };
+            });
+            if (p.table() != nullptr) {
+                table.nodes[nodes] = { p.table(), p.table_size(), 0, 0, params };
+                params += p.table_size();
+                table.children[node.offset + i] = nodes++;
+            }
+        }
+        node.last = routes;
+        sort_routes(table.routes, node.first, node.last);
+    }
+    return table;
+}
+
+// Indices plus one of short flag routes, -c or -c=, by node and character
+template<std::size_t Nodes, class Table>
+constexpr std::array<std::size_t, Nodes * 256> build_flags(const Table& table) {
+    std::array<std::size_t, Nodes * 256> flags {};
+    for(std::size_t n = 0; n < Nodes; ++n)
+        for(std::size_t i = table.nodes[n].first; i < table.nodes[n].last; ++i) {
+            const auto name = table.routes[i].name;
+            if (name.size() < 2 || name.size() > 3 || name[0] != '-' || name[1] == '-' || name[1] == '=') continue;
+            if (name.size() == 3 && name[2] != '=') continue;
+            auto& flag = flags[n * 256 + static_cast<unsigned char>(name[1])];
+            if (flag == 0) flag = i + 1;
+        }
+    return flags;
+}
+
+} // namespace detail
+
+// How names given in arguments match names and aliases of parameters, options may be combined:
+// exactly, also by any prefix that is unique among the parameters of the table,
+// also as short flags -a -b -c clustered in one argument -abc
+enum class Matching : unsigned { exact = 0, prefix = 1, clusters = 2 };
+constexpr Matching operator|(Matching a, Matching b) noexcept {
+    return static_cast<Matching>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+constexpr bool enabled(Matching set, Matching option) noexcept {
+    return (static_cast<unsigned>(set) & static_cast<unsigned>(option)) != 0;
+}
+
+// Dispatch structure for a constexpr parameters table and all its nested tables, built at compile time.
+// Names are looked up with a binary search over routes sorted by name
+template<const auto& Params, Matching Match = Matching::exact>
+class StaticDispatcher {
+public:
+    using parameter_type = typename std::remove_cv_t<std::remove_reference_t<decltype(Params)>>::value_type;
+    using class_type = typename parameter_type::class_type;
+    using node_type = std::size_t;
+    using route_type = detail::Route<parameter_type>;
+    static constexpr bool matches_prefixes = enabled(Match, Matching::prefix);
+    static constexpr bool matches_clusters = enabled(Match, Matching::clusters);
+
+    static constexpr node_type root() noexcept { return 0; }
+    // Returns parameter matching name, positional parameter or nullptr
+    static constexpr const parameter_type* find(std::string_view name) noexcept {
+        auto p = find(root(), name);
+        return p != nullptr ? p : positional(root());
+    }
+    // Returns parameter exactly matching name in the table of node
+    static constexpr const parameter_type* find(node_type node, std::string_view name) noexcept {
+        const auto& n = table.nodes[node];
+        auto found = lower_bound(n.first, n.last, name);
+        if (found != n.last && table.routes[found].name == name) return table.routes[found].parameter;
+        if constexpr (matches_prefixes) {
+            const parameter_type* result = nullptr;
+            return candidates(node, name, [&result](const route_type& route) { result = route.parameter; }) == 1 ? result : nullptr;
+        }
+        return nullptr;
+    }
+    // Calls put with the first route of each parameter whose name or alias starts with the prefix, returns their count.
+    // A prefix ending with '=' matches only names ending with '=', other prefixes only names without it
+    template<class Put>
+    static constexpr std::size_t candidates(node_type node, std::string_view prefix, Put&& put) noexcept {
+        const auto& n = table.nodes[node];
+        const bool valued = !prefix.empty() && prefix.back() == '=';
+        if (valued) prefix.remove_suffix(1);
+        if (prefix.empty()) return 0;
+        std::size_t count = 0;
+        const auto first = lower_bound(n.first, n.last, prefix);
+        for(auto i = first; i < n.last && table.routes[i].name.substr(0, prefix.size()) == prefix; ++i) {
+            const auto& route = table.routes[i];
+            if ((route.name.back() == '=') != valued) continue;
+            bool seen = false;
+            for(auto j = first; j < i && !seen; ++j) seen = table.routes[j].parameter == route.parameter;
+            if (seen) continue;
+            put(route);
+            ++count;
+        }
+        return count;
+    }
+    // Route of the short flag -c or -c= of the node, when clusters are enabled
+    static constexpr const route_type* flag(node_type node, char c) noexcept {
+        if constexpr (matches_clusters) {
+            const auto route = flags[node * 256 + static_cast<unsigned char>(c)];
+            return route != 0 ? &table.routes[route - 1] : nullptr;
+        }
+        return nullptr;
+    }
+    static constexpr const parameter_type* positional(node_type node) noexcept {
+        const auto& n = table.nodes[node];
+        return n.first != n.last && table.routes[n.first].name.empty() ? table.routes[n.first].parameter : nullptr;
+    }
+    static constexpr node_type child(node_type node, const parameter_type& p) noexcept {
+        const auto& n = table.nodes[node];
+        return table.children[n.offset + static_cast<std::size_t>(&p - n.begin)];
+    }
+    static constexpr Level<class_type> level(node_type node) noexcept {
+        return { table.nodes[node].begin, table.nodes[node].size };
+    }
+    // Routes of the node, sorted by name
+    static constexpr const route_type* routes_begin(node_type node) noexcept { return table.routes.data() + table.nodes[node].first; }
+    static constexpr const route_type* routes_end(node_type node) noexcept { return table.routes.data() + table.nodes[node].last; }
+    static constexpr const parameter_type* begin() noexcept { return Params.data(); }
+    static constexpr const parameter_type* end() noexcept { return Params.data() + Params.size(); }
+    static constexpr std::size_t size() noexcept { return Params.size(); }
+
+private:
+    static constexpr std::size_t node_count = detail::count_nodes(Params.data(), Params.size());
+    static constexpr std::size_t route_count = detail::count_routes(Params.data(), Params.size());
+    static constexpr std::size_t param_count = detail::count_params(Params.data(), Params.size());
+    static constexpr auto table = detail::build_routes<parameter_type, node_count, route_count, param_count>(Params.data(), Params.size());
+    static constexpr auto flags = detail::build_flags<matches_clusters ? node_count : 0>(table);
+
+    static constexpr std::size_t lower_bound(std::size_t first, std::size_t last, std::string_view name) noexcept {
+        while(first < last) {
+            const auto middle = first + (last - first) / 2;
+            if (table.routes[middle].name < name) first = middle + 1;
+            else last = middle;
+        }
+        return first;
+    }
+};
+
+} // namespace simplearg
@@ -1,27 +1,83 @@
 #pragma once
+#include <array>
 #include <string>
 #include <vector>
 namespace simplearg {
-// Breaks str into vector of tokens, replaces spaces with '\0'.
-inline std::vector<char*> str2argv(std::string& str, char comment = '#') {
-    std::vector<char*> result {};
-    enum class state_t { space, comment, start, token } state {};
-    enum class symbol_t { space, comment, token, eol } symbol {};
+namespace detail {
+struct tokenizer {
+    enum class state_t { space, comment, start, token };
+    enum class symbol_t { space, comment, token, eol };
     static constexpr state_t transitions[4][4] {
         { state_t::space, state_t::comment, state_t::start, state_t::space }, // space
         { state_t::comment, state_t::comment, state_t::comment, state_t::space }, // comment
         { state_t::space, state_t::comment, state_t::token, state_t::space }, // start
         { state_t::space, state_t::comment, state_t::token, state_t::space }, // token
     };
-    for(auto& chr: str) {
-        symbol = chr == '\n' ? symbol_t::eol : chr <= ' ' ? symbol_t::space : chr == comment ? symbol_t::comment : symbol_t::token;
-        if (symbol != symbol_t::token) chr = '\0';
-        state = transitions[static_cast<int>(state)][static_cast<int>(symbol)];
-        if (state == state_t::start) {
-          result.emplace_back(&chr);
+    static constexpr symbol_t symbol(char chr, char comment) noexcept {
+        return chr == '\n' ? symbol_t::eol : chr <= ' ' ? symbol_t::space : chr == comment ? symbol_t::comment : symbol_t::token;
+    }
+    static constexpr state_t next(state_t state, symbol_t symbol) noexcept {
+        return transitions[static_cast<int>(state)][static_cast<int>(symbol)];
+    }
+};
+} // namespace detail
+
+// Breaks [begin, end) into vector of tokens in place, replaces spaces with '\0'.
+inline std::vector<char*> str2argv(char* begin, char* end, char comment = '#') {
+    using tokenizer = detail::tokenizer;
+    std::vector<char*> result {};
+    tokenizer::state_t state {};
+    for(auto chr = begin; chr != end; ++chr) {
+        const auto symbol = tokenizer::symbol(*chr, comment);
+        if (symbol != tokenizer::symbol_t::token) *chr = '\0';
+        state = tokenizer::next(state, symbol);
+        if (state == tokenizer::state_t::start) {
+          result.emplace_back(chr);
         }
     }
     return result;
 }
 
+// Breaks str into vector of tokens, replaces spaces with '\0'.
+inline std::vector<char*> str2argv(std::string& str, char comment = '#') {
+    return str2argv(str.data(), str.data() + str.size(), comment);
+}
+
+// Counts tokens in str at compile time
+template<std::size_t Length>
+constexpr std::size_t count_tokens(const char (&str)[Length], char comment = '#') noexcept {
+    using tokenizer = detail::tokenizer;
+    std::size_t result {};
+    tokenizer::state_t state {};
+    for(std::size_t i = 0; i + 1 < Length; ++i) {
+        state = tokenizer::next(state, tokenizer::symbol(str[i], comment));
+        if (state == tokenizer::state_t::start) ++result;
+    }
+    return result;
+}
+
+// Compile time counterpart of str2argv, returns copy of str with spaces replaced by '\0'
+template<std::size_t Length>
+constexpr std::array<char, Length> tokenize(const char (&str)[Length], char comment = '#') noexcept {
+    using tokenizer = detail::tokenizer;
+    std::array<char, Length> result {};
+    for(std::size_t i = 0; i + 1 < Length; ++i)
+        result[i] = tokenizer::symbol(str[i], comment) == tokenizer::symbol_t::token ? str[i] : '\0';
+    return result;
+}
+
+// Returns offsets of tokens in str at compile time
+template<std::size_t Count, std::size_t Length>
+constexpr std::array<std::size_t, Count> token_offsets(const char (&str)[Length], char comment = '#') noexcept {
+    using tokenizer = detail::tokenizer;
+    std::array<std::size_t, Count> result {};
+    std::size_t count {};
+    tokenizer::state_t state {};
+    for(std::size_t i = 0; i + 1 < Length && count < Count; ++i) {
+        state = tokenizer::next(state, tokenizer::symbol(str[i], comment));
+        if (state == tokenizer::state_t::start) result[count++] = i;
+    }
+    return result;
+}
+
 } // namespace simplearg
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * suggest.h - ranking of names by edit distance for "did you mean" suggestions
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace simplearg {
+namespace detail {
+
+// Levenshtein distance from a fixed word to candidates, with the bit-parallel algorithm
+// of Myers in the global form of Hyyrö. One pass of 64-bit operations per candidate character,
+// words longer than 64 characters are compared by their first 64
+class Distance {
+public:
+    explicit Distance(std::string_view word) noexcept : size_ { word.size() < 64 ? word.size() : 64 } {
+        for(std::size_t i = 0; i < size_; ++i) peq_[static_cast<unsigned char>(word[i])] |= std::uint64_t { 1 } << i;
+    }
+    std::size_t operator()(std::string_view candidate) const noexcept {
+        if (size_ == 0) return candidate.size();
+        const std::uint64_t last = std::uint64_t { 1 } << (size_ - 1);
+        std::uint64_t pv = ~std::uint64_t {};
+        std::uint64_t mv = 0;
+        std::size_t score = size_;
+        for(auto chr : candidate) {
+            const std::uint64_t eq = peq_[static_cast<unsigned char>(chr)];
+            const std::uint64_t xv = eq | mv;
+            const std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            std::uint64_t ph = mv | ~(xh | pv);
+            std::uint64_t mh = pv & xh;
+            if (ph & last) ++score;
+            else if (mh & last) --score;
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+        }
+        return score;
+    }
+    std::size_t size() const noexcept { return size_; }
+private:
+    std::array<std::uint64_t, 256> peq_ {};
+    std::size_t size_;
+};
+
+// Keeps K closest candidates within a distance bound, ordered by distance
+template<std::size_t K>
+class Suggestions {
+public:
+    explicit Suggestions(std::string_view word) noexcept
+      : distance_ { word }, bound_ { distance_.size() / 3 < 2 ? 2 : distance_.size() / 3 } {}
+    void add(std::string_view candidate) noexcept {
+        if (candidate.empty()) return;
+        const auto diff = candidate.size() > distance_.size() ? candidate.size() - distance_.size() : distance_.size() - candidate.size();
+        if (diff > bound_) return;
+        auto d = distance_(candidate);
+        if (d > bound_ || (size_ == K && d >= entries_[K - 1].distance)) return;
+        for(std::size_t i = 0; i < size_; ++i) if (entries_[i].name == candidate) return;
+        std::size_t i = size_ < K ? size_++ : K - 1;
+        for(; i > 0 && entries_[i - 1].distance > d; --i) entries_[i] = entries_[i - 1];
+        entries_[i] = { candidate, d };
+    }
+    const auto* begin() const noexcept { return entries_.data(); }
+    const auto* end() const noexcept { return entries_.data() + size_; }
+    std::size_t size() const noexcept { return size_; }
+private:
+    struct Entry {
+        std::string_view name;
+        std::size_t distance;
+    };
+    Distance distance_;
+    std::size_t bound_;
+    std::array<Entry, K> entries_ {};
+    std::size_t size_ {};
+};
+
+} // namespace detail
+} // namespace simplearg
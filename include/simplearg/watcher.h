@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * watcher.h - incremental reload of configuration files with inotify
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <simplearg/arguments.h>
+#include <simplearg/str2argv.h>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace simplearg {
+
+// Watches configuration files and dispatches only lines added or changed since the previous load.
+// Lines removed from a file are not dispatched, lines that failed are dispatched again on the next load
+template<class Class>
+class Watcher {
+public:
+    template<std::size_t Size>
+    Watcher(Class& obj, const Parameters<Class, Size>& params, char comment = '#')
+      : obj_ { obj }, dispatcher_ { params }, comment_ { comment },
+        fd_ { inotify_init1(IN_NONBLOCK | IN_CLOEXEC) } {}
+    Watcher(const Watcher&) = delete;
+    Watcher& operator=(const Watcher&) = delete;
+    ~Watcher() { if (fd_ >= 0) ::close(fd_); }
+
+    // Starts watching path and dispatches all its lines
+    bool add(const std::string& path) {
+        if (fd_ < 0) return error("inotify is not available");
+        const auto slash = path.rfind('/');
+        const auto dir = slash == path.npos ? std::string { "." } : path.substr(0, slash + 1);
+        const int wd = inotify_add_watch(fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) return error("cannot watch '", dir, '\'');
+        files_.push_back({ path, path.substr(slash == path.npos ? 0 : slash + 1), wd, {} });
+        return reload(files_.back());
+    }
+
+    // Waits up to timeout milliseconds for changes and dispatches changed lines
+    // Returns false on errors of this call, available via errors()
+    bool poll(int timeout = -1) {
+        if (fd_ < 0) return error("inotify is not available");
+        pollfd pfd { fd_, POLLIN, 0 };
+        const int ready = ::poll(&pfd, 1, timeout);
+        if (ready < 0 && errno != EINTR) return error("cannot poll inotify");
+        if (ready <= 0) return true;
+        alignas(inotify_event) char buffer[4096];
+        std::vector<File*> changed {};
+        for(;;) {
+            const auto size = ::read(fd_, buffer, sizeof(buffer));
+            if (size <= 0) break;
+            for(auto ptr = buffer; ptr < buffer + size; ) {
+                auto event = reinterpret_cast<const inotify_event*>(ptr);
+                ptr += sizeof(inotify_event) + event->len;
+                if (event->len == 0) continue;
+                const std::string_view name { event->name };
+                for(auto& f : files_) {
+                    if (f.wd != event->wd || f.name != name) continue;
+                    bool seen = false;
+                    for(auto c : changed) seen = seen || c == &f;
+                    if (!seen) changed.push_back(&f);
+                }
+            }
+        }
+        bool result = true;
+        for(auto f : changed) result = reload(*f) && result;
+        return result;
+    }
+
+    int fd() const noexcept { return fd_; }
+    std::string errors() {
+        std::string result { std::move(errors_) };
+        errors_.clear();
+        return result;
+    }
+
+private:
+    struct File {
+        std::string path;
+        std::string name;
+        int wd;
+        std::unordered_multiset<std::string> lines;
+    };
+
+    bool reload(File& file) {
+        std::string content {};
+        if (!read(file.path, content)) return error("cannot read '", file.path, '\'');
+        std::unordered_multiset<std::string> lines {};
+        bool result = true;
+        int number = 0;
+        for(auto begin = content.data(), end = begin + content.size(); begin < end; ) {
+            auto eol = static_cast<char*>(std::memchr(begin, '\n', static_cast<std::size_t>(end - begin)));
+            if (eol == nullptr) eol = end;
+            ++number;
+            auto tokens = str2argv(begin, eol < end ? eol + 1 : end, comment_);
+            begin = eol + 1;
+            if (tokens.empty()) continue;
+            std::string line {};
+            for(auto token : tokens) (line += token) += '\0';
+            auto previous = file.lines.find(line);
+            if (previous != file.lines.end()) {
+                file.lines.erase(previous);
+                lines.insert(std::move(line));
+                continue;
+            }
+            Arguments args { static_cast<int>(tokens.size()), tokens.data() };
+            if (args.parse(obj_, dispatcher_))
+                lines.insert(std::move(line));
+            else
+                result = error(file.path, ':', std::to_string(number), ": ", args.errors());
+        }
+        file.lines = std::move(lines);
+        return result;
+    }
+    static bool read(const std::string& path, std::string& content) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        char buffer[4096];
+        for(;;) {
+            const auto got = ::read(fd, buffer, sizeof(buffer));
+            if (got <= 0) {
+                ::close(fd);
+                return got == 0;
+            }
+            content.append(buffer, static_cast<std::size_t>(got));
+        }
+    }
+    template<typename ... T>
+    bool error(T ... str) {
+        if (!errors_.empty()) errors_ += '\n';
+        ((errors_ += str), ...);
+        return false;
+    }
+
+    Class& obj_;
+    Dispatcher<Class> dispatcher_;
+    char comment_;
+    int fd_;
+    std::vector<File> files_ {};
+    std::string errors_ {};
+};
+
+} // namespace simplearg
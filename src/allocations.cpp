@@ -0,0 +1,113 @@
+#define SIMPLEARG_ALLOCATIONS
+#include <simplearg/allocations.h>
+#include <simplearg/arguments.h>
+#include <simplearg/static_dispatcher.h>
+#include <simplearg/str2argv.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+using namespace simplearg;
+
+// Parameters table of the demo, with handlers that do not print
+struct Test {
+    unsigned u {};
+    short i {};
+    std::string s;
+    bool foo(std::string_view name, Arguments& args) {
+        args.errors(std::string{name} + ' ');
+        return args.getall(u, s, i);
+    }
+    bool option(std::string_view name, Arguments& args) {
+        args.errors(std::string{name} + ' ');
+        return args.getall(s);
+    }
+    bool bar(std::string_view name, Arguments& args) {
+        args.errors(std::string{name} + ' ');
+        return args.getall(u, s);
+    }
+    bool flag(std::string_view, Arguments&) { return true; }
+    static constexpr simplearg::Parameters<Test, 7> params = {{
+        {&Test::option, "--option=", "a parameter with one option", "" },
+        {&Test::foo, "foo", "a foo parameter", "f"},
+        {&Test::bar, "bar", "a bar parameter", "b ba bbar"},
+        {&Test::flag, "-", "a dash parameter", "" },
+        {&Test::flag, "--", "a double dash parameter", "" },
+        {&Test::flag, "help", "prints this help", "--help -h -?" },
+        {&Test::flag, "", "any positional argument", "" },
+    }};
+};
+
+// Upper bounds of allocations and retained bytes of each path, exceeding them is a regression.
+// Bounds of paths that build standard containers are those of libstdc++
+struct Expected {
+    std::size_t count;
+    std::size_t retained;
+};
+
+bool report(const char* name, const Allocations& a, Expected expected) {
+    const bool result = a.count <= expected.count && a.retained <= expected.retained;
+    std::cout << std::left << std::setw(24) << name << std::right
+              << std::setw(8) << a.count << std::setw(10) << a.bytes << std::setw(10) << a.peak << std::setw(10) << a.retained;
+    if (!result) std::cout << "  expected at most " << expected.count << " allocations, " << expected.retained << " retained";
+    std::cout << '\n';
+    return result;
+}
+
+int main() {
+    std::cout << std::left << std::setw(24) << "" << std::right
+              << std::setw(8) << "allocs" << std::setw(10) << "bytes" << std::setw(10) << "peak" << std::setw(10) << "retained" << '\n';
+    bool result = true;
+    std::string line { "--option=value foo 1 bar -2 bar 3 ba - -- help positional\n" };
+    std::vector<char*> tokens {};
+    {
+        AllocationScope scope {};
+        tokens = str2argv(line);
+        result = report("str2argv", scope.result(), { 5, 128 }) && result;
+    }
+    std::unique_ptr<Dispatcher<Test>> dispatcher {};
+    {
+        AllocationScope scope {};
+        dispatcher = std::make_unique<Dispatcher<Test>>(Test::params);
+        result = report("Dispatcher", scope.result(), { 26, 1056 }) && result;
+    }
+    {
+        Test test {};
+        AllocationScope scope {};
+        Arguments args { static_cast<int>(tokens.size()), tokens.data() };
+        args.parse(test, *dispatcher);
+        result = report("parse", scope.result(), { 0, 0 }) && result;
+    }
+    {
+        Test test {};
+        AllocationScope scope {};
+        Arguments args { static_cast<int>(tokens.size()), tokens.data() };
+        args.parse(test, Test::params);
+        result = report("parse with table", scope.result(), { 25, 0 }) && result;
+    }
+    {
+        Test test {};
+        AllocationScope scope {};
+        Arguments args { static_cast<int>(tokens.size()), tokens.data() };
+        args.parse(test, StaticDispatcher<Test::params>{});
+        result = report("parse static", scope.result(), { 0, 0 }) && result;
+    }
+    {
+        Test test {};
+        const char* values[] = { "foo", "x" };
+        AllocationScope scope {};
+        Arguments args { 2, values };
+        args.parse(test, *dispatcher);
+        result = report("parse with error", scope.result(), { 2, 71 }) && result;
+    }
+    {
+        unsigned u {};
+        std::string s {};
+        const char* values[] = { "42", "value" };
+        AllocationScope scope {};
+        Arguments args { 2, values };
+        args.getall(u, s);
+        result = report("getall", scope.result(), { 0, 0 }) && result;
+    }
+    return result ? 0 : 1;
+}
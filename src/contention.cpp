@@ -0,0 +1,83 @@
+#include <simplearg/arguments.h>
+#include <simplearg/published.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+using namespace simplearg;
+
+struct Settings {
+    unsigned limit {};
+    std::string name {};
+    bool setlimit(std::string_view, Arguments& args) { return args.get(limit); }
+    bool setname(std::string_view, Arguments& args) { return args.get(name); }
+    static constexpr simplearg::Parameters<Settings, 2> params = {{
+        {&Settings::setlimit, "--limit=", "a number", ""},
+        {&Settings::setname, "--name=", "a string", ""},
+    }};
+};
+
+struct Bench {
+    unsigned readers { std::thread::hardware_concurrency() };
+    unsigned seconds { 1 };
+    bool setreaders(std::string_view, Arguments& args) { return args.get(readers); }
+    bool setseconds(std::string_view, Arguments& args) { return args.get(seconds); }
+    bool help(std::string_view, Arguments&) {
+        print(std::cout << "Usage: contention [options]\n", params);
+        seconds = 0;
+        return true;
+    }
+    static constexpr simplearg::Parameters<Bench, 3> params = {{
+        {&Bench::setreaders, "--readers=", "number of reader threads", "-r="},
+        {&Bench::setseconds, "--seconds=", "duration of the benchmark", "-s="},
+        {&Bench::help, "help", "prints this help", "--help -h -?" },
+    }};
+};
+
+int main(int argc, char* argv[]) {
+    Arguments args{argc-1, argv+1};
+    Bench bench {};
+    if (args && !args.parse(bench, Bench::params)) {
+        std::cerr << args.errors() << '\n';
+        return 1;
+    }
+    if (bench.seconds == 0) return 0;
+    Published<Settings> published {};
+    std::atomic<bool> stop {};
+    std::atomic<unsigned long long> reads {}, checksum {};
+    std::vector<std::thread> threads {};
+    for(unsigned i = 0; i < bench.readers; ++i) {
+        threads.emplace_back([&published, &stop, &reads, &checksum] {
+            auto reader = published.reader();
+            unsigned long long count {}, sum {};
+            while(!stop.load(std::memory_order_relaxed)) {
+                sum += reader->limit;
+                ++count;
+            }
+            reads += count;
+            checksum += sum;
+        });
+    }
+    unsigned long long reloads {};
+    const auto start = std::chrono::steady_clock::now();
+    const auto until = start + std::chrono::seconds(bench.seconds);
+    while(std::chrono::steady_clock::now() < until) {
+        std::string limit = "--limit=" + std::to_string(reloads);
+        char name[] = "--name=bench";
+        char* values[] = { limit.data(), name };
+        Arguments config { 2, values };
+        if (!published.reload(config, Settings::params)) {
+            std::cerr << config.errors() << '\n';
+            break;
+        }
+        ++reloads;
+    }
+    stop = true;
+    for(auto& t : threads) t.join();
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Readers: " << bench.readers << '\n'
+              << "Reads/s: " << reads / elapsed << '\n'
+              << "Reloads/s: " << reloads / elapsed << '\n';
+    return 0;
+}
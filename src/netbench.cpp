@@ -0,0 +1,74 @@
+#include <simplearg/arguments.h>
+#include <simplearg/network.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace simplearg;
+
+struct Acl {
+    std::vector<Cidr> allow {};
+    std::vector<std::pair<std::string, int>> strings {};
+    bool cidr(std::string_view, Arguments& args) {
+        Cidr value {};
+        if (!args.get(value)) return false;
+        allow.push_back(value);
+        return true;
+    }
+    bool libc(std::string_view, Arguments& args) {
+        std::string value {};
+        if (!args.get(value)) return false;
+        const auto slash = value.find('/');
+        if (slash == value.npos) return false;
+        std::string address = value.substr(0, slash);
+        unsigned char bytes[16];
+        const int family = address.find(':') == address.npos ? AF_INET : AF_INET6;
+        if (inet_pton(family, address.c_str(), bytes) != 1) return false;
+        strings.emplace_back(std::move(address), std::stoi(value.substr(slash + 1)));
+        return true;
+    }
+    static constexpr simplearg::Parameters<Acl, 1> fast = {{
+        {&Acl::cidr, "--allow=", "allowed network", ""},
+    }};
+    static constexpr simplearg::Parameters<Acl, 1> slow = {{
+        {&Acl::libc, "--allow=", "allowed network", ""},
+    }};
+};
+
+template<std::size_t Size>
+double measure(const std::vector<const char*>& argv, const Parameters<Acl, Size>& params, unsigned iterations) {
+    const Dispatcher<Acl> dispatcher { params };
+    const auto start = std::chrono::steady_clock::now();
+    for(unsigned i = 0; i < iterations; ++i) {
+        Acl acl {};
+        Arguments args { static_cast<int>(argv.size()), argv.data() };
+        if (!args.parse(acl, dispatcher)) {
+            std::cerr << args.errors() << '\n';
+            return 0;
+        }
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned entries { 5000 }, iterations { 100 };
+    Arguments args{argc-1, argv+1};
+    if (args && !args.getall(entries, iterations)) {
+        std::cerr << "Usage: netbench [entries [iterations]]\n" << args.errors() << '\n';
+        return 1;
+    }
+    std::vector<std::string> storage {};
+    for(unsigned i = 0; i < entries; ++i) {
+        if (i % 2)
+            storage.push_back("--allow=10." + std::to_string(i >> 16 & 255) + '.' + std::to_string(i >> 8 & 255) + '.' + std::to_string(i & 255) + "/32");
+        else
+            storage.push_back("--allow=2001:db8:" + std::to_string(i % 9999) + "::" + std::to_string(i % 777) + "/64");
+    }
+    std::vector<const char*> values {};
+    for(auto& s : storage) values.push_back(s.c_str());
+    std::cout << "Entries: " << entries << '\n'
+              << "simplearg: " << measure(values, Acl::fast, iterations) << " ms\n"
+              << "inet_pton: " << measure(values, Acl::slow, iterations) << " ms\n";
+    return 0;
+}
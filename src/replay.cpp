@@ -0,0 +1,103 @@
+#include <simplearg/arguments.h>
+#include <simplearg/recorder.h>
+#include <simplearg/str2argv.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+using namespace simplearg;
+
+// A table with immediate, deferred and parallel parameters standing for a server command set
+struct Server {
+    unsigned long sum {};
+    bool set(std::string_view, Arguments& args) {
+        std::string key {};
+        unsigned value {};
+        if (!args.getall(key, value)) return false;
+        sum += key.size() + value;
+        return true;
+    }
+    bool commit(std::string_view, Arguments&) {
+        ++sum;
+        return true;
+    }
+    bool warm(std::string_view, Arguments& args) {
+        std::string_view value = args.get();
+        sum += value.size();
+        return true;
+    }
+    static constexpr Parameters<Server, 3> params = {{
+        {&Server::set, "set", "sets a key to a number", ""},
+        {&Server::commit, "--commit", "commits after the command", "", Execution::deferred},
+        {&Server::warm, "--warm=", "warms a cache", "", Execution::parallel},
+    }};
+};
+
+// Parses every line of a script and records it
+bool record(const std::string& script, const std::string& log) {
+    std::ifstream file { script };
+    if (!file) {
+        std::cerr << "cannot read '" << script << "'\n";
+        return false;
+    }
+    Recorder recorder { log };
+    Server server {};
+    const Dispatcher<Server> dispatcher { Server::params };
+    std::string line {};
+    std::size_t lines {}, failures {};
+    while(std::getline(file, line)) {
+        line += '\n';
+        auto tokens = str2argv(line);
+        if (tokens.empty()) continue;
+        Arguments args { static_cast<int>(tokens.size()), tokens.data() };
+        ++lines;
+        if (!recorder.parse(args, server, dispatcher)) ++failures;
+    }
+    if (!recorder.flush()) {
+        std::cerr << recorder.errors() << '\n';
+        return false;
+    }
+    std::cout << "Recorded " << lines << " lines, " << failures << " failed\n";
+    return true;
+}
+
+// Replays a log and reports its throughput and latencies, fails on mismatches
+bool run(const std::string& log, bool paced) {
+    Replay replay {};
+    if (!replay.load(log)) {
+        std::cerr << replay.errors() << '\n';
+        return false;
+    }
+    Server server {};
+    const auto stats = replay.run(server, Server::params, paced);
+    std::cout << "Records: " << stats.records << ", failures: " << stats.failures
+              << ", mismatches: " << stats.mismatches << '\n'
+              << stats.records / stats.seconds << " per second, p50 " << stats.p50 << " ns, p99 "
+              << stats.p99 << " ns, p99.9 " << stats.p999 << " ns, max " << stats.max << " ns\n";
+    return stats.mismatches == 0;
+}
+
+int main(int argc, char* argv[]) {
+    Arguments args{argc-1, argv+1};
+    std::string mode {}, first {}, second {};
+    if (args && args.getall(mode, first)) {
+        if (mode == "record" && args.get(second)) return record(first, second) ? 0 : 1;
+        if (mode == "run") return run(first, args.contains("paced")) ? 0 : 1;
+    }
+    if (argc > 1) {
+        std::cerr << "Usage: replay [record <script> <log> | run <log> [paced]]\n";
+        return 1;
+    }
+    // without arguments records a generated script and checks its replay
+    const std::string script { "replay.txt" }, log { "replay.rec" };
+    {
+        std::ofstream file { script };
+        for(unsigned i = 0; i < 10000; ++i)
+            file << "set key" << i % 100 << ' ' << i << (i % 3 ? " --commit" : "") << (i % 5 ? "" : " --warm=cache")
+                 << (i % 1000 ? "" : " --unknown") << '\n';
+    }
+    const bool result = record(script, log) && run(log, false);
+    std::remove(script.c_str());
+    std::remove(log.c_str());
+    return result ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+#include <simplearg/arguments.h>
+#include <simplearg/script.h>
+#include <simplearg/str2argv.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+using namespace simplearg;
+
+struct Counter {
+    unsigned long sum {};
+    bool add(std::string_view, Arguments& args) {
+        unsigned value {};
+        if (!args.get(value)) return false;
+        sum += value;
+        return true;
+    }
+    bool set(std::string_view, Arguments& args) {
+        std::string_view value = args.get();
+        sum += value.size();
+        return true;
+    }
+    static constexpr simplearg::Parameters<Counter, 2> params = {{
+        {&Counter::add, "add", "adds a number", ""},
+        {&Counter::set, "--set=", "sets a string", ""},
+    }};
+};
+
+// Reads the whole script, then tokenizes and dispatches it line by line on one thread
+bool serial(const std::string& path, Counter& counter) {
+    std::ifstream file { path };
+    std::string line {};
+    const Dispatcher<Counter> dispatcher { Counter::params };
+    while(std::getline(file, line)) {
+        line += '\n';
+        auto tokens = str2argv(line);
+        if (tokens.empty()) continue;
+        Arguments args { static_cast<int>(tokens.size()), tokens.data() };
+        if (!args.parse(counter, dispatcher)) return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned lines { 1000000 }, batches { 8 };
+    Arguments args{argc-1, argv+1};
+    if (args && !args.getall(lines, batches)) {
+        std::cerr << "Usage: scriptbench [lines batches]\n" << args.errors() << '\n';
+        return 1;
+    }
+    const std::string path { "scriptbench.txt" };
+    {
+        std::ofstream file { path };
+        for(unsigned i = 0; i < lines; ++i)
+            file << (i % 4 ? "add " + std::to_string(i % 1000) : "--set=value-" + std::to_string(i)) << "  # comment\n";
+    }
+    Counter pipelined {}, plain {};
+    Script<Counter> script { pipelined, Counter::params, batches };
+    if (!script.run(path)) {
+        std::cerr << script.errors() << '\n';
+        return 1;
+    }
+    const auto& stats = script.stats();
+    const auto start = std::chrono::steady_clock::now();
+    serial(path, plain);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::remove(path.c_str());
+    std::cout << "Lines: " << stats.lines << ", tokens: " << stats.tokens << '\n'
+              << "pipelined: " << stats.seconds << " s, " << stats.bytes / stats.seconds / 1e6 << " MB/s, stalls: producer "
+              << stats.producer_stalls << ", consumer " << stats.consumer_stalls << '\n'
+              << "serial:    " << seconds << " s\n";
+    return pipelined.sum == plain.sum ? 0 : 1;
+}
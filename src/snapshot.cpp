@@ -0,0 +1,127 @@
+#include <simplearg/arguments.h>
+#include <simplearg/snapshot.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace simplearg;
+
+struct Tool {
+    unsigned iterations { 1000 };
+    bool make(std::string_view name, Arguments& args) {
+        std::string file {};
+        args.errors(std::string{name} + ' ');
+        if (!args.getall(file)) return false;
+        std::string errors {};
+        if (!Snapshot::make(file.c_str(), errors)) return fail(name, args, errors);
+        std::cout << "Created " << Snapshot::path(file.c_str()) << '\n';
+        return true;
+    }
+    bool verify(std::string_view name, Arguments& args) {
+        std::string file {};
+        args.errors(std::string{name} + ' ');
+        if (!args.getall(file)) return false;
+        Snapshot snapshot {};
+        std::string errors {};
+        if (!snapshot.load(file.c_str(), errors) || !snapshot.verify(file.c_str(), errors)) return fail(name, args, errors);
+        std::cout << "Valid " << Snapshot::path(file.c_str()) << ", " << snapshot.size() << " arguments\n";
+        return true;
+    }
+    bool count(std::string_view name, Arguments& args) {
+        args.errors(std::string{name} + ' ');
+        return args.get(iterations);
+    }
+    // Both sides read the source with one read(2), first loads follow eviction of the files from the page cache
+    bool bench(std::string_view name, Arguments& args) {
+        using clock = std::chrono::steady_clock;
+        using us = std::chrono::duration<double, std::micro>;
+        std::string file {};
+        args.errors(std::string{name} + ' ');
+        if (!args.getall(file)) return false;
+        std::size_t tokens {};
+        Timing tokenize {}, snapshot {};
+        for(unsigned i = 0; i < iterations; ++i) {
+            if (i == 0) evict(file);
+            const auto start = clock::now();
+            std::string content {};
+            if (!read(file, content)) return fail(name, args, "cannot read '" + file + '\'');
+            tokens += str2argv(content).size();
+            tokenize.add(i, us(clock::now() - start).count());
+        }
+        for(unsigned i = 0; i < iterations; ++i) {
+            if (i == 0) {
+                evict(file);
+                evict(Snapshot::path(file.c_str()));
+            }
+            const auto start = clock::now();
+            Snapshot loaded {};
+            std::string errors {};
+            if (!loaded.load(file.c_str(), errors)) return fail(name, args, errors);
+            tokens += loaded.arguments() ? loaded.size() : 0;
+            snapshot.add(i, us(clock::now() - start).count());
+        }
+        std::cout << "Tokenize: first " << tokenize.first << " us, then " << tokenize.rest(iterations) << " us\n"
+                  << "Snapshot: first " << snapshot.first << " us, then " << snapshot.rest(iterations) << " us\n"
+                  << "Arguments: " << tokens / iterations / 2 << '\n';
+        return true;
+    }
+    bool help(std::string_view, Arguments&) {
+        print(std::cout << "Usage: snapshot <command> <file>\n", params);
+        return true;
+    }
+    struct Timing {
+        double first {};
+        double total {};
+        void add(unsigned i, double us) noexcept { (i == 0 ? first : total) += us; }
+        double rest(unsigned iterations) const noexcept { return iterations > 1 ? total / (iterations - 1) : 0; }
+    };
+    // Drops cached pages of the file, so the next read goes to the device as on the first start
+    static void evict(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        ::fdatasync(fd);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+    static bool read(const std::string& path, std::string& content) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st {};
+        bool result = fstat(fd, &st) == 0;
+        if (result) content.resize(static_cast<std::size_t>(st.st_size));
+        for(std::size_t pos = 0; result && pos < content.size(); ) {
+            const auto got = ::read(fd, content.data() + pos, content.size() - pos);
+            result = got > 0;
+            if (result) pos += static_cast<std::size_t>(got);
+        }
+        ::close(fd);
+        return result;
+    }
+    static bool fail(std::string_view name, Arguments& args, const std::string& errors) {
+        args.errors(std::string{name} + ' ' + errors);
+        return false;
+    }
+    static constexpr simplearg::Parameters<Tool, 5> params = {{
+        {&Tool::make, "make", "creates snapshot of a config file", "m"},
+        {&Tool::verify, "verify", "verifies snapshot against a config file", "v"},
+        {&Tool::count, "--iterations=", "number of iterations for bench", "-n="},
+        {&Tool::bench, "bench", "compares loading with and without snapshot", "b"},
+        {&Tool::help, "help", "prints this help", "--help -h -?" },
+    }};
+};
+
+int main(int argc, char* argv[]) {
+    Arguments args{argc-1, argv+1};
+    Tool tool {};
+    if (!args) {
+        print(std::cout << "Usage: snapshot <command> <file>\n", Tool::params);
+        return 1;
+    }
+    if (!args.parse(tool, Tool::params)) {
+        std::cerr << args.errors() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <simplearg/adaptive.h>
+#include <sstream>
+#include <string>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Server {
+    std::string log {};
+    bool verb(std::string_view name, Arguments&) {
+        (log += name) += ' ';
+        return true;
+    }
+    static constexpr Parameters<Server, 5> params = {{
+        { &Server::verb, "get", "gets a key", "g" },
+        { &Server::verb, "set", "sets a key", "s" },
+        { &Server::verb, "del", "deletes a key", "" },
+        { &Server::verb, "stat", "reports statistics", "" },
+        { &Server::verb, "list", "lists keys", "ls" },
+    }};
+};
+
+using Cached = std::array<const Parameter<Server>*, AdaptiveDispatcher<Server>::cache_size>;
+const auto& params = Server::params;
+
+void lookup(const AdaptiveDispatcher<Server>& dispatcher, std::string_view name, int times) {
+    for(int i = 0; i < times; ++i) CHECK(dispatcher.find(name) != nullptr);
+}
+
+} // namespace
+
+int main() {
+    AdaptiveDispatcher<Server> dispatcher { Server::params, {}, 8 };
+    CHECK((dispatcher.cached() == Cached {}));
+    CHECK(dispatcher.find("g") == &params[0] && dispatcher.find("ls") == &params[4] && dispatcher.find("x") == nullptr);
+    lookup(dispatcher, "s", 3);
+    lookup(dispatcher, "set", 3);
+    // the cache is rebuilt on every eighth lookup, aliases count for their parameters
+    CHECK((dispatcher.cached() == Cached { &params[1], &params[0], &params[4], &params[3] }));
+    lookup(dispatcher, "ls", 7);
+    lookup(dispatcher, "list", 1);
+    CHECK((dispatcher.cached() == Cached { &params[4], &params[1], &params[0], &params[3] }));
+    CHECK(dispatcher.find("list") == &params[4] && dispatcher.find("ls") == &params[4] && dispatcher.find("set") == &params[1]);
+
+    std::ostringstream out {};
+    dispatcher.export_order(out, 3);
+    CHECK(out.str() == R"({ "list", "set", "get" })");
+    // the exported order, pasted as it is, warms the cache of a later build
+    const AdaptiveDispatcher<Server> warm { Server::params, { "list", "set", "get" } };
+    CHECK((warm.cached() == Cached { &params[4], &params[1], &params[0], nullptr }));
+
+    const char* values[] = { "ls", "g", "del", "list" };
+    Arguments args { 4, values };
+    Server server {};
+    CHECK(args.parse(server, warm));
+    CHECK(server.log == "ls g del list ");
+    return test::failures != 0;
+}
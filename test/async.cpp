@@ -0,0 +1,96 @@
+#include <simplearg/async.h>
+#include <string>
+#include <vector>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Control {
+    Executor& executor;
+    std::vector<std::string> log {};
+    Task set(std::string_view name, Arguments& args) {
+        co_await executor.schedule();
+        std::string value {};
+        if (!args.get(value)) co_return false;
+        log.push_back(std::string { name } + ' ' + value);
+        co_return value != "fail";
+    }
+    Task fetch(std::string_view, Arguments& args) {
+        const std::string value { args.get() };
+        log.push_back("start " + value);
+        co_await executor.schedule();
+        log.push_back("done " + value);
+        co_return true;
+    }
+    Task size(std::string_view, Arguments& args) {
+        co_await executor.schedule();
+        unsigned value {};
+        co_return args.get(value);
+    }
+    Task commit(std::string_view name, Arguments&) {
+        co_await executor.schedule();
+        log.emplace_back(name);
+        co_return true;
+    }
+    static constexpr AsyncParameters<Control, 4> params = {{
+        { &Control::set, "set", "sets a value", "s" },
+        { &Control::fetch, "--fetch=", "fetches a url", "", Execution::parallel },
+        { &Control::size, "--size=", "checks a size", "", Execution::parallel },
+        { &Control::commit, "--commit", "commits after all others", "-c", Execution::deferred },
+    }};
+};
+
+using Log = std::vector<std::string>;
+
+// Runs async_parse of values to completion, errors are returned through errors
+Log run(std::initializer_list<const char*> values, bool& result, std::string& errors) {
+    std::vector<const char*> argv { values };
+    Arguments args { static_cast<int>(argv.size()), argv.data() };
+    Executor executor {};
+    Control control { executor };
+    Task task = async_parse(args, control, AsyncDispatcher<Control> { Control::params });
+    result = executor.run(task);
+    CHECK(task.done());
+    errors = args.errors();
+    return control.log;
+}
+
+} // namespace
+
+int main() {
+    bool result {};
+    std::string errors {};
+    CHECK((run({ "--commit", "--fetch=a", "set", "1", "--fetch=b", "s", "2" }, result, errors)
+        == Log { "start a", "done a", "set 1", "start b", "done b", "s 2", "--commit" }));
+    CHECK(result && errors.empty());
+
+    // parallel handlers are started when seen and run interleaved with immediate ones
+    CHECK((run({ "--fetch=a", "--fetch=b", "set", "1" }, result, errors)
+        == Log { "start a", "start b", "done a", "done b", "set 1" }));
+    CHECK(result);
+
+    // failures of parallel handlers are aggregated, deferred ones are skipped
+    CHECK((run({ "-c", "--size=x", "--size=7", "--size=y" }, result, errors).empty()));
+    CHECK(!result);
+    CHECK(errors == "--size= expects number in place of 'x'; --size= expects number in place of 'y'");
+
+    // a failed immediate handler stops parsing, started parallel handlers are still awaited
+    CHECK((run({ "--fetch=a", "set", "fail", "set", "2", "-c" }, result, errors)
+        == Log { "start a", "done a", "set fail" }));
+    CHECK(!result);
+
+    CHECK((run({ "--fetch=a", "unknown" }, result, errors) == Log { "start a", "done a" }));
+    CHECK(!result);
+    CHECK(errors.rfind("Unknown verb 'unknown' expected one of: set --fetch= --size= --commit", 0) == 0);
+
+    const AsyncDispatcher<Control> dispatcher { Control::params };
+    const char* values[] = { "--fetch=a", "-c", "set", "1" };
+    Arguments args { 4, values };
+    Executor executor {};
+    Control control { executor };
+    Task task = async_parse(args, control, dispatcher);
+    CHECK(executor.run(task));
+    CHECK((control.log == Log { "start a", "done a", "set 1", "-c" }));
+    return test::failures != 0;
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * check.h - minimal checks for SimpleArg tests
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <iostream>
+
+namespace test {
+
+inline int failures = 0;
+
+inline bool check(bool condition, const char* expression, const char* file, int line) {
+    if (condition) return true;
+    std::cerr << file << ':' << line << ": check failed: " << expression << '\n';
+    ++failures;
+    return false;
+}
+
+} // namespace test
+
+#define CHECK(condition) ::test::check((condition), #condition, __FILE__, __LINE__)
@@ -0,0 +1,61 @@
+#include <simplearg/arguments.h>
+#include <string>
+#include <utility>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+enum class Color { red, green, blue };
+
+// A table of a few hundred values, generated at compile time
+constexpr std::size_t size = 300;
+struct Names {
+    char names[size][6];
+};
+constexpr Names make_names() {
+    Names result {};
+    for(std::size_t i = 0; i < size; ++i) {
+        result.names[i][0] = 'k';
+        result.names[i][1] = static_cast<char>('0' + i / 100);
+        result.names[i][2] = static_cast<char>('0' + i / 10 % 10);
+        result.names[i][3] = static_cast<char>('0' + i % 10);
+    }
+    return result;
+}
+constexpr Names names = make_names();
+template<std::size_t ... I>
+constexpr auto make_table(std::index_sequence<I...>) {
+    const std::pair<const char*, int> table[] = { { names.names[I], static_cast<int>(I) }... };
+    return make_choices(table);
+}
+constexpr auto large = make_table(std::make_index_sequence<size> {});
+
+constexpr bool all_found() {
+    for(std::size_t i = 0; i < size; ++i) {
+        auto found = large.find(names.names[i]);
+        if (found == nullptr || *found != static_cast<int>(i)) return false;
+    }
+    return true;
+}
+static_assert(all_found());
+static_assert(large.find("k300") == nullptr);
+static_assert(large.find("") == nullptr);
+
+} // namespace
+
+template<> struct simplearg::choices<Color> {
+    static constexpr auto value = make_choices<Color>({{"red", Color::red}, {"green", Color::green}, {"blue", Color::blue}});
+};
+
+int main() {
+    static_assert(*choices<Color>::value.find("green") == Color::green);
+    static_assert(choices<Color>::value.find("Green") == nullptr);
+    const char* values[] = { "blue", "purple" };
+    Arguments args { 2, values };
+    Color color {};
+    CHECK(args.get(color) && color == Color::blue);
+    CHECK(!args.get(color));
+    CHECK(args.errors() == "expects one of red green blue in place of 'purple'");
+    return test::failures != 0;
+}
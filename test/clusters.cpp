@@ -0,0 +1,71 @@
+#include <simplearg/static_dispatcher.h>
+#include <string>
+#include <vector>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Flags {
+    std::vector<std::string> log {};
+    std::string output {};
+    bool flag(std::string_view name, Arguments&) {
+        log.emplace_back(name);
+        return true;
+    }
+    bool note(std::string_view name, Arguments& args) {
+        std::string value {};
+        if (!args.get(value)) return false;
+        log.push_back(std::string { name } + ' ' + value);
+        return true;
+    }
+    static constexpr Parameters<Flags, 5> params = {{
+        { &Flags::flag, "--all", "all", "-a" },
+        { &Flags::flag, "-b", "brief", "" },
+        { bind<&Flags::output>, "--output=", "output file", "-o=" },
+        { &Flags::note, "-n", "notes the next argument", "" },
+        { &Flags::flag, "", "any word", "" },
+    }};
+};
+
+using Log = std::vector<std::string>;
+using Clusters = StaticDispatcher<Flags::params, Matching::clusters>;
+
+// Parses values and returns the handler log and the output, errors are returned through errors,
+// failed when parse failed without a message
+Log parse(std::initializer_list<const char*> values, std::string& output, std::string& errors) {
+    std::vector<const char*> argv { values };
+    Arguments args { static_cast<int>(argv.size()), argv.data() };
+    Flags flags {};
+    errors = args.parse(flags, Clusters {}) ? std::string {} : args.errors().empty() ? "failed" : args.errors();
+    output = flags.output;
+    return flags.log;
+}
+
+} // namespace
+
+int main() {
+    std::string output {}, errors {};
+    CHECK((parse({ "-abo", "val", "word" }, output, errors) == Log { "-a", "-b", "word" }));
+    CHECK(output == "val" && errors.empty());
+    CHECK((parse({ "-aboval" }, output, errors) == Log { "-a", "-b" }));
+    CHECK(output == "val" && errors.empty());
+    CHECK((parse({ "-abo=val" }, output, errors) == Log { "-a", "-b" }));
+    CHECK(output == "val" && errors.empty());
+    CHECK((parse({ "-oab" }, output, errors).empty()));
+    CHECK(output == "ab" && errors.empty());
+    CHECK((parse({ "-ban", "x" }, output, errors) == Log { "-b", "-a", "-n x" }));
+    CHECK(errors.empty());
+
+    CHECK((parse({ "-anb", "x" }, output, errors) == Log { "-a", "-n x" }));
+    CHECK(errors == "flag '-n' takes arguments and cannot be followed by others in '-anb'");
+    CHECK((parse({ "-abo" }, output, errors) == Log { "-a", "-b" }));
+    CHECK(errors == "failed" && output.empty());
+    CHECK((parse({ "-az" }, output, errors) == Log { "-az" }));
+    CHECK(errors.empty());
+
+    static_assert(Clusters::flag(Clusters::root(), 'a')->name == "-a");
+    static_assert(Clusters::flag(Clusters::root(), 'o')->name == "-o=");
+    static_assert(Clusters::flag(Clusters::root(), 'z') == nullptr);
+    return test::failures != 0;
+}
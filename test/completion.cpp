@@ -0,0 +1,78 @@
+#include <simplearg/completion.h>
+#include <string>
+#include <unistd.h>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Connections { int size; int max; };
+struct Db { Connections pool; std::string host; };
+struct Config {
+    Db db {};
+    bool verbose {};
+    bool flag(std::string_view, Arguments&) { return verbose = true; }
+};
+
+constexpr Parameters<Config, 2> pool_params = {{
+    { bind<&Config::db, &Db::pool, &Connections::size>, "size=", "pool size", "" },
+    { bind<&Config::db, &Db::pool, &Connections::max>, "max=", "pool limit", "" },
+}};
+constexpr Parameters<Config, 3> db_params = {{
+    { pool_params, "pool.", "connection pool", "" },
+    { bind<&Config::db, &Db::host>, "host=", "database host", "" },
+    { bind<&Config::db, &Db::host>, "hosts=", "database hosts", "" },
+}};
+constexpr Parameters<Config, 2> remote_params = {{
+    { &Config::flag, "remove", "removes a remote", "rm" },
+    { &Config::flag, "add", "adds a remote", "" },
+}};
+constexpr Parameters<Config, 4> params = {{
+    { &Config::flag, "--version", "prints the version", "" },
+    { &Config::flag, "--verbose", "verbose output", "-v" },
+    { db_params, "--db.", "database", "" },
+    { remote_params, "remote", "manages remotes", "" },
+}};
+
+// Runs a completion query and returns what it wrote to a pipe
+template<class D>
+std::string complete(const D& dispatcher, std::initializer_list<const char*> words) {
+    int fds[2];
+    if (::pipe(fds) != 0) return "no pipe";
+    std::vector<const char*> argv { words };
+    const bool result = simplearg::complete(dispatcher, static_cast<int>(argv.size()), argv.data(), fds[1]);
+    ::close(fds[1]);
+    std::string reply {};
+    char buffer[256];
+    for(ssize_t got; (got = ::read(fds[0], buffer, sizeof(buffer))) > 0;) reply.append(buffer, static_cast<std::size_t>(got));
+    ::close(fds[0]);
+    return result ? reply : "failed";
+}
+
+template<class D>
+void check(const D& dispatcher) {
+    CHECK(complete(dispatcher, { "--ver" }) == "--verbose\n--version\n");
+    CHECK(complete(dispatcher, { "" }) == "--db.\n--verbose\n--version\n-v\nremote\n");
+    CHECK(complete(dispatcher, {}) == "--db.\n--verbose\n--version\n-v\nremote\n");
+    CHECK(complete(dispatcher, { "-" }) == "--db.\n--verbose\n--version\n-v\n");
+    CHECK(complete(dispatcher, { "x" }).empty());
+    CHECK(complete(dispatcher, { "remote", "" }) == "add\nremove\nrm\n");
+    CHECK(complete(dispatcher, { "remote", "re" }) == "remove\n");
+    CHECK(complete(dispatcher, { "-v", "remote", "r" }) == "remove\nrm\n");
+    CHECK(complete(dispatcher, { "--db." }) == "--db.host=\n--db.hosts=\n--db.pool.\n");
+    CHECK(complete(dispatcher, { "--db.h" }) == "--db.host=\n--db.hosts=\n");
+    CHECK(complete(dispatcher, { "--db.pool." }) == "--db.pool.max=\n--db.pool.size=\n");
+    CHECK(complete(dispatcher, { "--db.pool.s" }) == "--db.pool.size=\n");
+    CHECK(complete(dispatcher, { "--db.x.s" }).empty());
+    CHECK(complete(dispatcher, { "--db.", "po" }) == "pool.\n");
+}
+
+} // namespace
+
+int main() {
+    check(Dispatcher<Config> { params });
+    check(StaticDispatcher<params> {});
+    CHECK(complete(params, { "--v" }) == "--verbose\n--version\n");
+    CHECK(!simplearg::complete(params, 1, std::array<const char*, 1> { "" }.data(), -1));
+    return test::failures != 0;
+}
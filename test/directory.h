@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2024 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * directory.h - temporary directory for SimpleArg tests
+ *
+ * Licensed under MIT License, see full text in LICENSE
+ * or visit page https://opensource.org/license/mit/
+ */
+
+#pragma once
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+namespace test {
+
+struct Directory {
+    Directory() {
+        char path[] = "/tmp/simplearg-XXXXXX";
+        if (::mkdtemp(path) != nullptr) name = path;
+    }
+    ~Directory() { std::system(("rm -rf " + name).c_str()); }
+    std::string write(const char* file, const char* text) const {
+        const auto path = name + '/' + file;
+        std::ofstream { path } << text;
+        return path;
+    }
+    std::string name {};
+};
+
+} // namespace test
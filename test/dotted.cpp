@@ -0,0 +1,77 @@
+#include <simplearg/static_dispatcher.h>
+#include <string>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Connections { int size {}; int max {}; };
+struct Db { Connections pool {}; std::string host {}; };
+struct Config {
+    Db db {};
+    unsigned port {};
+    bool verbose {};
+    bool flag(std::string_view, Arguments&) { return verbose = true; }
+};
+
+constexpr Parameters<Config, 2> pool_params = {{
+    { bind<&Config::db, &Db::pool, &Connections::size>, "size=", "pool size", "" },
+    { bind<&Config::db, &Db::pool, &Connections::max>, "max=", "pool limit", "" },
+}};
+constexpr Parameters<Config, 2> db_params = {{
+    { pool_params, "pool.", "connection pool", "" },
+    { bind<&Config::db, &Db::host>, "host=", "database host", "" },
+}};
+constexpr Parameters<Config, 3> params = {{
+    { db_params, "--db.", "database", "" },
+    { bind<&Config::port>, "--port=", "port", "" },
+    { &Config::flag, "--verbose", "verbose output", "-v" },
+}};
+
+template<class D>
+void check(const D& dispatcher) {
+    {
+        const char* values[] = { "--db.pool.size=32", "-v", "--db.host=db.local", "--port=80", "--db.pool.max=64" };
+        Arguments args { 5, values };
+        Config config {};
+        CHECK(args.parse(config, dispatcher));
+        CHECK(config.db.pool.size == 32 && config.db.pool.max == 64 && config.db.host == "db.local");
+        CHECK(config.port == 80 && config.verbose);
+    }
+    {
+        const char* values[] = { "--db.pool.size=x" };
+        Arguments args { 1, values };
+        Config config {};
+        CHECK(!args.parse(config, dispatcher));
+        CHECK(args.errors() == "expects number in place of 'x'");
+    }
+    {
+        const char* values[] = { "--db.pool.limit=8" };
+        Arguments args { 1, values };
+        Config config {};
+        CHECK(!args.parse(config, dispatcher));
+        CHECK(args.errors().rfind("Unknown verb '--db.pool.limit='", 0) == 0);
+    }
+    {
+        // a group given alone selects its table for the following arguments
+        const char* values[] = { "--db.", "host=h", "pool.size=4" };
+        Arguments args { 3, values };
+        Config config {};
+        CHECK(args.parse(config, dispatcher));
+        CHECK(config.db.host == "h" && config.db.pool.size == 4);
+    }
+    {
+        const char* values[] = { "--db.port=8" };
+        Arguments args { 1, values };
+        Config config {};
+        CHECK(!args.parse(config, dispatcher));
+    }
+}
+
+} // namespace
+
+int main() {
+    check(Dispatcher<Config> { params });
+    check(StaticDispatcher<params> {});
+    return test::failures != 0;
+}
@@ -0,0 +1,43 @@
+#include <simplearg/embedded.h>
+#include <string>
+#include <string_view>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Options {
+    unsigned port {};
+    std::string name {};
+    bool verbose {};
+    bool flag(std::string_view, Arguments&) { return verbose = true; }
+    static constexpr Parameters<Options, 3> params = {{
+        { bind<&Options::port>, "--port=", "port", "" },
+        { bind<&Options::name>, "--name", "name", "-n" },
+        { &Options::flag, "--verbose", "verbose output", "-v" },
+    }};
+};
+
+static constexpr char defaults[] = "--port=80 # the default port\n\t-n  local\n--verbose\n# trailing comment";
+using Defaults = Embedded<defaults>;
+static_assert(Defaults::count == 4);
+static_assert(std::string_view { Defaults::values[0] } == "--port=80");
+static_assert(std::string_view { Defaults::values[1] } == "-n");
+static_assert(std::string_view { Defaults::values[2] } == "local");
+static_assert(std::string_view { Defaults::values[3] } == "--verbose");
+
+static constexpr char empty[] = "  # nothing but a comment\n";
+static_assert(Embedded<empty>::count == 0);
+static constexpr char semicolons[] = "--port=1; --verbose";
+static_assert(Embedded<semicolons, ';'>::count == 1 && std::string_view { Embedded<semicolons, ';'>::values[0] } == "--port=1");
+
+} // namespace
+
+int main() {
+    auto args = Defaults::arguments();
+    Options options {};
+    CHECK(args.parse(options, Options::params));
+    CHECK(options.port == 80 && options.name == "local" && options.verbose);
+    CHECK(!Embedded<empty>::arguments());
+    return test::failures != 0;
+}
@@ -0,0 +1,41 @@
+#include <simplearg/environment.h>
+#include <string>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Options {
+    unsigned limit {};
+    std::string name {};
+    bool set_limit(std::string_view, Arguments& args) { return args.get(limit); }
+    bool set_name(std::string_view, Arguments& args) { return args.get(name); }
+    static constexpr Parameters<Options, 2> params = {{
+        { &Options::set_limit, "--max-conn=", "connection limit", "", "" },
+        { &Options::set_name, "--name=", "a name", "", "NAME" },
+    }};
+};
+
+} // namespace
+
+int main() {
+    const std::string long_name(200, 'x');
+    std::string long_var = "APP_" + std::string(200, 'X') + "=long";
+    char max_conn[] = "APP_MAX_CONN=12";
+    char name[] = "NAME=env";
+    char* env[] = { max_conn, name, long_var.data(), nullptr };
+    const Environment environment { std::string { "APP_" }, env };
+    CHECK(environment.find("NAME") != nullptr);
+    CHECK(std::string { environment.find("", "--max-conn=") } == "12");
+    CHECK(std::string { environment.find("", "--" + long_name + "=") } == "long");
+    CHECK(environment.find("", "--" + long_name + "y=") == nullptr);
+    CHECK(environment.find(nullptr, "--max-conn=") == nullptr);
+    {
+        const char* values[] = { "--name=arg" };
+        Arguments args { 1, values };
+        Options options {};
+        CHECK(args.parse(options, Options::params, environment));
+        CHECK(options.limit == 12 && options.name == "arg");
+    }
+    return test::failures != 0;
+}
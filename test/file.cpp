@@ -0,0 +1,59 @@
+#include <simplearg/file.h>
+#include <simplearg/program.h>
+#include <string>
+#include "check.h"
+#include "directory.h"
+using namespace simplearg;
+
+namespace {
+
+struct Config {
+    FilePath schema {};
+    static constexpr Parameters<Config, 1> params = {{
+        { bind<&Config::schema>, "--schema=", "schema file", "" },
+    }};
+};
+
+std::string content(const FilePath& file) {
+    char buffer[16] {};
+    const auto got = ::pread(file.fd(), buffer, sizeof(buffer), 0);
+    return got > 0 ? std::string(buffer, static_cast<std::size_t>(got)) : std::string {};
+}
+
+} // namespace
+
+int main() {
+    test::Directory dir {};
+    if (!CHECK(!dir.name.empty())) return 1;
+    const auto option = "--schema=" + dir.write("schema.txt", "schema");
+    {
+        std::string value { option };
+        const char* values[] = { value.c_str() };
+        Arguments args { 1, values };
+        Config config {};
+        CHECK(args.parse(config, Config::params));
+        value.assign(value.size(), 'x');
+        CHECK(config.schema.path() == dir.name + "/schema.txt");
+        const Config copy { config };
+        CHECK(copy.schema && copy.schema.fd() != config.schema.fd());
+        CHECK(content(copy.schema) == "schema");
+    }
+    {
+        const char* values[] = { option.c_str() };
+        Arguments args { 1, values };
+        Program<Config> program {};
+        CHECK(program.compile(args, Config::params));
+        Config first {}, second {};
+        CHECK(program.run(first) && program.run(second));
+        CHECK(content(first.schema) == "schema" && content(second.schema) == "schema");
+        CHECK(first.schema.fd() != second.schema.fd());
+    }
+    {
+        const char* values[] = { "--schema=/nonexistent/schema.txt" };
+        Arguments args { 1, values };
+        Config config {};
+        CHECK(!args.parse(config, Config::params));
+        CHECK(!config.schema);
+    }
+    return test::failures != 0;
+}
@@ -0,0 +1,42 @@
+#include <simplearg/response.h>
+#include <string>
+#include "check.h"
+#include "directory.h"
+using namespace simplearg;
+
+int main() {
+    {
+        const char* values[] = { "--port=80", "-v", "--name", "x", "--port=81", "--tail" };
+        Arguments args { 6, values };
+        CHECK(args.has("-v"));
+        CHECK(!args.has("-q"));
+        CHECK(args.value("--port=", 0) == 81);
+        CHECK(args.value<std::string>("--name", "none") == "x");
+        CHECK(args.value<std::string>("--tail", "none") == "none");
+        std::string value {};
+        CHECK(args.get(value) && args.get(value));
+        CHECK(!args.has("-v"));
+        CHECK(args.value("--port=", 0) == 81);
+    }
+    {
+        test::Directory dir {};
+        if (!CHECK(!dir.name.empty())) return 1;
+        const auto at = '@' + dir.write("args.rsp", "--port=81 -v --name\n");
+        const char* values[] = { at.c_str(), "y", "--size=3" };
+        ResponseFiles files {};
+        Arguments args { 3, values, files };
+        CHECK(args.value("--port=", 0) == 81);
+        CHECK(args.value("--size=", 0) == 3);
+        CHECK(args.has("-v"));
+        CHECK(args.value<std::string>("--name", "none") == "none");
+        std::string value {};
+        CHECK(args.get(value) && value == "--port=81");
+        CHECK(args.has("-v"));
+        CHECK(args.get(value) && value == "-v");
+        CHECK(!args.has("-v"));
+        CHECK(!args.has("--port="));
+        CHECK(args.value("--size=", 0) == 3);
+        CHECK(args.errors().empty());
+    }
+    return test::failures != 0;
+}
@@ -0,0 +1,90 @@
+#include <simplearg/metrics.h>
+#include <string>
+#include <type_traits>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Server {
+    unsigned size {};
+    bool get(std::string_view, Arguments& args) {
+        std::string key {};
+        return args.get(key);
+    }
+    bool fail(std::string_view, Arguments&) { return false; }
+    bool later(std::string_view, Arguments&) { return true; }
+    bool set_size(std::string_view, Arguments& args) { return args.get(size); }
+    static constexpr Parameters<Server, 1> db = {{
+        { &Server::set_size, "--size=", "pool size", "" },
+    }};
+    static constexpr Parameters<Server, 4> params = {{
+        { &Server::get, "get", "gets a key", "g" },
+        { &Server::fail, "--fail", "always fails", "" },
+        { &Server::later, "--later", "a deferred call", "", Execution::deferred },
+        { db, "db", "database settings", "" },
+    }};
+};
+
+using M = Metrics<Server>;
+
+// Buckets are exact below 8 and split each power of two in four above
+static_assert(M::bucket(0) == 0 && M::bucket(3) == 3 && M::bucket(4) == 4 && M::bucket(7) == 7);
+static_assert(M::bucket(8) == 8 && M::bucket(9) == 8 && M::bucket(10) == 9 && M::bucket(15) == 11 && M::bucket(16) == 12);
+static_assert(M::upper(0) == 0 && M::upper(7) == 7 && M::upper(8) == 9 && M::upper(11) == 15 && M::upper(12) == 19);
+static_assert(M::bucket(~std::uint64_t {}) == M::buckets - 1 && M::upper(M::buckets - 1) == ~std::uint64_t {});
+// a parse without a probe carries no instrumentation
+static_assert(std::is_empty_v<detail::NoProbe>);
+
+const M::Sample* find(const std::vector<M::Sample>& samples, std::string_view name) {
+    for(auto& s : samples) if (s.name == name) return &s;
+    return nullptr;
+}
+
+bool parse(std::initializer_list<const char*> values, M& metrics) {
+    std::vector<const char*> argv { values };
+    Arguments args { static_cast<int>(argv.size()), argv.data() };
+    Server server {};
+    return args.parse(server, Server::params, metrics);
+}
+
+} // namespace
+
+int main() {
+    bool bounds = true;
+    for(std::uint64_t v = 1; v != 0; v <<= 1)
+        for(auto n : { v - 1, v, v + 1 }) {
+            const auto b = M::bucket(n);
+            bounds = bounds && b < M::buckets && M::upper(b) >= n && (b == 0 || M::upper(b - 1) < n);
+        }
+    CHECK(bounds);
+
+    M metrics { Server::params };
+    CHECK(metrics.snapshot().empty());
+    CHECK(parse({ "get", "a", "g", "b", "--later", "db", "--size=4" }, metrics));
+    CHECK(!parse({ "get", "c", "--fail", "get", "d" }, metrics));
+    CHECK(!parse({ "db", "--size=x" }, metrics));
+    auto samples = metrics.snapshot();
+    CHECK(samples.size() == 5);
+    auto get = find(samples, "get");
+    CHECK(get != nullptr && get->hits == 3 && get->failures == 0);
+    auto fail = find(samples, "--fail");
+    CHECK(fail != nullptr && fail->hits == 1 && fail->failures == 1);
+    auto later = find(samples, "--later");
+    CHECK(later != nullptr && later->hits == 1 && later->failures == 0);
+    auto size = find(samples, "--size=");
+    CHECK(size != nullptr && size->hits == 2 && size->failures == 1);
+    std::uint64_t total {};
+    for(auto h : get->histogram) total += h;
+    CHECK(total == 3);
+    CHECK(get->percentile(1.0) >= get->percentile(0.5) && get->percentile(1.0) > 0);
+
+    Server server {};
+    const char* values[] = { "get", "e" };
+    Arguments plain { 2, values };
+    CHECK(plain.parse(server, Server::params));
+    CHECK(find(metrics.snapshot(), "get")->hits == 3);
+    metrics.reset();
+    CHECK(metrics.snapshot().empty());
+    return test::failures != 0;
+}
@@ -0,0 +1,44 @@
+#include <simplearg/network.h>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+constexpr bool valid(std::string_view str) noexcept {
+    IPv6 value {};
+    return from_arg(str, value);
+}
+
+constexpr IPv6 parse(std::string_view str) noexcept {
+    IPv6 value {};
+    from_arg(str, value);
+    return value;
+}
+
+static_assert(valid("::"));
+static_assert(valid("1::"));
+static_assert(valid("::1"));
+static_assert(valid("1:2:3:4:5:6:7:8"));
+static_assert(valid("1:2:3:4:5:6:7::"));
+static_assert(valid("::2:3:4:5:6:7:8"));
+static_assert(valid("::ffff:192.0.2.1"));
+static_assert(!valid("1:2:3:4:5:6:7:8::"));
+static_assert(!valid("::1:2:3:4:5:6:7:8"));
+static_assert(!valid("1:2:3:4::5:6:7:8"));
+static_assert(!valid("1:2:3:4:5:6:7"));
+static_assert(!valid("1::2::3"));
+static_assert(!valid("1:::2"));
+static_assert(!valid(":1"));
+static_assert(!valid("1:"));
+static_assert(parse("1:2:3:4:5:6:7::").bytes[13] == 7 && parse("1:2:3:4:5:6:7::").bytes[15] == 0);
+static_assert(parse("::2:3:4:5:6:7:8").bytes[1] == 0 && parse("::2:3:4:5:6:7:8").bytes[3] == 2);
+static_assert(parse("fe80::1").bytes[0] == 0xfe && parse("fe80::1").bytes[15] == 1);
+
+} // namespace
+
+int main() {
+    Address address {};
+    CHECK(from_arg("1:2:3:4:5:6:7:8", address) && address.family == Address::Family::ipv6);
+    CHECK(!from_arg("1:2:3:4:5:6:7:8::", address));
+    return test::failures != 0;
+}
@@ -0,0 +1,79 @@
+#include <simplearg/pool.h>
+#include <simplearg/arguments.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Loader {
+    std::vector<std::string> order {};
+    std::atomic<int> loaded {};
+    bool load(std::string_view, Arguments& args) {
+        std::string path {};
+        if (!args.get(path)) return false;
+        if (path == "bad") {
+            args.errors("cannot load");
+            return false;
+        }
+        ++loaded;
+        return true;
+    }
+    bool record(std::string_view name, Arguments&) {
+        order.emplace_back(name);
+        return true;
+    }
+    static constexpr Parameters<Loader, 4> params = {{
+        { &Loader::load, "--load=", "loads a file in parallel", "", Execution::parallel },
+        { &Loader::record, "--last", "runs after parsing", "", Execution::deferred },
+        { &Loader::record, "--first", "runs immediately", "" },
+        { &Loader::record, "--then", "runs immediately", "" },
+    }};
+};
+
+// a user type of this name must not clash with the library under using namespace
+struct Pool {
+    int size {};
+    static constexpr Parameters<Pool, 1> params = {{
+        { bind<&Pool::size>, "--size=", "pool size", "" },
+    }};
+};
+
+} // namespace
+
+int main() {
+    HandlerPool pool { 4 };
+    {
+        const char* values[] = { "--size=3" };
+        Arguments args { 1, values };
+        Pool user {};
+        CHECK(args.parse(user, Pool::params, pool));
+        CHECK(user.size == 3);
+    }
+    {
+        const char* values[] = { "--last", "--load=a", "--first", "--load=b", "--load=c", "--then" };
+        Arguments args { 6, values };
+        Loader loader {};
+        CHECK(args.parse(loader, Loader::params, pool));
+        CHECK(loader.loaded == 3);
+        CHECK((loader.order == std::vector<std::string> { "--first", "--then", "--last" }));
+    }
+    {
+        const char* values[] = { "--load=bad", "--load=a", "--load=bad" };
+        Arguments args { 3, values };
+        Loader loader {};
+        CHECK(!args.parse(loader, Loader::params, pool));
+        CHECK(loader.loaded == 1);
+        CHECK(args.errors() == "--load= cannot load; --load= cannot load");
+    }
+    {
+        const char* values[] = { "--load=a", "--load=b" };
+        Arguments args { 2, values };
+        Loader loader {};
+        CHECK(args.parse(loader, Loader::params));
+        CHECK(loader.loaded == 2);
+    }
+    return test::failures != 0;
+}
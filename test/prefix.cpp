@@ -0,0 +1,100 @@
+#include <simplearg/static_dispatcher.h>
+#include <string>
+#include <vector>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Verbs {
+    std::vector<std::string> log {};
+    bool verb(std::string_view name, Arguments&) {
+        log.emplace_back(name);
+        return true;
+    }
+    bool option(std::string_view name, Arguments& args) {
+        std::string value {};
+        if (!args.get(value)) return false;
+        log.push_back(std::string { name } + value);
+        return true;
+    }
+    static constexpr Parameters<Verbs, 7> params = {{
+        { &Verbs::verb, "start", "starts", "" },
+        { &Verbs::verb, "status", "reports status", "" },
+        { &Verbs::verb, "stat", "reports statistics", "" },
+        { &Verbs::verb, "stop", "stops", "" },
+        { &Verbs::verb, "restart", "restarts", "reboot" },
+        { &Verbs::option, "--output=", "output file", "" },
+        { &Verbs::option, "--outdir=", "output directory", "" },
+    }};
+};
+
+// A table with a positional parameter, words that are not verbs go to it
+struct Words {
+    std::vector<std::string> log {};
+    bool verb(std::string_view name, Arguments&) {
+        log.emplace_back(name);
+        return true;
+    }
+    bool word(std::string_view name, Arguments&) {
+        log.push_back('+' + std::string { name });
+        return true;
+    }
+    static constexpr Parameters<Words, 3> params = {{
+        { &Words::verb, "start", "starts", "" },
+        { &Words::verb, "status", "reports status", "" },
+        { &Words::word, "", "any word", "" },
+    }};
+};
+
+template<class D>
+std::vector<std::string> words(std::initializer_list<const char*> values, const D& dispatcher, std::string& errors) {
+    std::vector<const char*> argv { values };
+    Arguments args { static_cast<int>(argv.size()), argv.data() };
+    Words words {};
+    errors = args.parse(words, dispatcher) ? std::string {} : args.errors();
+    return words.log;
+}
+
+using Log = std::vector<std::string>;
+using Prefixed = StaticDispatcher<Verbs::params, Matching::prefix>;
+
+// Parses values and returns the log of handlers, errors are returned through errors
+Log parse(std::initializer_list<const char*> values, std::string& errors) {
+    std::vector<const char*> argv { values };
+    Arguments args { static_cast<int>(argv.size()), argv.data() };
+    Verbs verbs {};
+    errors = args.parse(verbs, Prefixed {}) ? std::string {} : args.errors();
+    return verbs.log;
+}
+
+} // namespace
+
+int main() {
+    std::string errors {};
+    CHECK((parse({ "sto", "stat", "statu", "star" }, errors) == Log { "sto", "stat", "statu", "star" }) && errors.empty());
+    CHECK((parse({ "re", "reb" }, errors) == Log { "re", "reb" }) && errors.empty());
+    CHECK((parse({ "--outp=a", "--outd=b" }, errors) == Log { "--outp=a", "--outd=b" }) && errors.empty());
+
+    CHECK(parse({ "stop", "sta" }, errors) == Log { "stop" });
+    CHECK(errors == "Ambiguous verb 'sta' matches: start stat status");
+    CHECK(parse({ "st" }, errors).empty());
+    CHECK(errors == "Ambiguous verb 'st' matches: start stat status stop");
+    CHECK(parse({ "--out=x" }, errors).empty());
+    CHECK(errors == "Ambiguous verb '--out=' matches: --outdir= --output=");
+    CHECK(parse({ "--outp" }, errors).empty());
+    CHECK(errors.rfind("Unknown verb '--outp'", 0) == 0);
+
+    // exact matching leaves words that are prefixes of verbs to the positional parameter
+    CHECK((words({ "sta", "start" }, StaticDispatcher<Words::params> {}, errors) == Log { "+sta", "start" }) && errors.empty());
+    CHECK((words({ "sta", "start" }, Dispatcher<Words> { Words::params }, errors) == Log { "+sta", "start" }) && errors.empty());
+    CHECK((words({ "star" }, StaticDispatcher<Words::params, Matching::prefix> {}, errors) == Log { "star" }) && errors.empty());
+    CHECK(words({ "sta" }, StaticDispatcher<Words::params, Matching::prefix> {}, errors).empty());
+    CHECK(errors == "Ambiguous verb 'sta' matches: start status");
+
+    static_assert(Prefixed::find(Prefixed::root(), "stat") == &Verbs::params[2]);
+    static_assert(Prefixed::find(Prefixed::root(), "sto") == &Verbs::params[3]);
+    static_assert(Prefixed::find(Prefixed::root(), "sta") == nullptr);
+    static_assert(StaticDispatcher<Verbs::params>::find(StaticDispatcher<Verbs::params>::root(), "sto") == nullptr);
+    return test::failures != 0;
+}
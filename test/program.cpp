@@ -0,0 +1,85 @@
+#include <simplearg/program.h>
+#include <simplearg/static_dispatcher.h>
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Settings {
+    int size {};
+    std::string name {};
+    std::vector<std::string> log {};
+    bool twice(std::string_view, Arguments&) {
+        size *= 2;
+        return true;
+    }
+    bool note(std::string_view name, Arguments& args) {
+        std::string value {};
+        if (!args.get(value)) return false;
+        log.push_back(std::string { name } + value);
+        return true;
+    }
+    bool flag(std::string_view name, Arguments&) {
+        log.emplace_back(name);
+        return true;
+    }
+    static constexpr Parameters<Settings, 6> params = {{
+        { bind<&Settings::size>, "--size=", "a size", "-s=" },
+        { bind<&Settings::name>, "--name=", "a name", "" },
+        { &Settings::twice, "--twice", "doubles the size", "-t" },
+        { &Settings::note, "--note", "notes the next argument", "-n" },
+        { &Settings::flag, "--later", "a deferred flag", "-l", Execution::deferred },
+        { &Settings::flag, "-v", "a flag", "" },
+    }};
+    bool operator==(const Settings& other) const {
+        return size == other.size && name == other.name && log == other.log;
+    }
+};
+
+// Runs the program compiled from values on a copy of initial and compares it with parsing them
+template<class D>
+bool same(std::initializer_list<const char*> values, const D& dispatcher, const Settings& initial = {}) {
+    std::vector<const char*> argv { values };
+    Settings parsed { initial };
+    Arguments parse { static_cast<int>(argv.size()), argv.data() };
+    if (!CHECK(parse.parse(parsed, dispatcher))) return false;
+    Program<Settings> program {};
+    Arguments compile { static_cast<int>(argv.size()), argv.data() };
+    if (!CHECK(program.compile(compile, dispatcher))) return false;
+    Settings replayed { initial };
+    return CHECK(program.run(replayed)) && CHECK(replayed == parsed);
+}
+
+} // namespace
+
+int main() {
+    const Dispatcher<Settings> dispatcher { Settings::params };
+    same({ "--size=5", "--twice", "--name=x" }, dispatcher);
+    same({ "--twice", "--size=3" }, dispatcher);
+    same({ "--size=3", "--size=4", "--twice", "--size=5", "--note", "a" }, dispatcher);
+    same({ "--later", "--size=2", "--twice" }, dispatcher, Settings { 7, "y", {} });
+    same({ "--twice", "--note", "b", "-v" }, dispatcher, Settings { 7, "y", {} });
+    same({ "-vts=4", "-n", "c", "-vtn", "d", "-s", "6" }, StaticDispatcher<Settings::params, Matching::clusters> {});
+    same({ "-vs4", "-t" }, StaticDispatcher<Settings::params, Matching::clusters> {});
+
+    const char* values[] = { "--size=5", "--twice" };
+    Arguments args { 2, values };
+    Program<Settings> program {};
+    CHECK(program.compile(args, Settings::params));
+    CHECK(program.size() == 2);
+    std::vector<Settings> many(64, Settings { 1, {}, {} });
+    HandlerPool pool { 4 };
+    CHECK(program.run(many.begin(), many.end(), &pool));
+    bool all = true;
+    for(auto& s : many) all = all && s.size == 10;
+    CHECK(all);
+
+    const char* bad[] = { "--size=x" };
+    Arguments failed { 1, bad };
+    CHECK(!program.compile(failed, Settings::params));
+    CHECK(program.errors() == "expects number in place of 'x'");
+    return test::failures != 0;
+}
@@ -0,0 +1,76 @@
+#include <simplearg/published.h>
+#include <thread>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Settings {
+    unsigned limit { 10 };
+    unsigned depth { 1 };
+    bool set_limit(std::string_view, Arguments& args) { return args.get(limit); }
+    bool set_depth(std::string_view, Arguments& args) { return args.get(depth); }
+    static constexpr Parameters<Settings, 2> params = {{
+        { &Settings::set_limit, "--limit=", "request limit", "" },
+        { &Settings::set_depth, "--depth=", "queue depth", "" },
+    }};
+};
+
+bool reload(Published<Settings>& published, const char* value) {
+    const char* values[] = { value };
+    Arguments args { 1, values };
+    return published.reload(args, Settings::params);
+}
+
+} // namespace
+
+int main() {
+    Published<Settings> published {};
+    auto reader = published.reader();
+    CHECK(published.version() == 0 && reader.version() == 0);
+    CHECK(reader->limit == 10);
+    const auto held = published.load();
+
+    // a reader sees the new version, a snapshot held before stays valid and unchanged
+    CHECK(reload(published, "--limit=20"));
+    CHECK(published.version() == 1);
+    CHECK(reader->limit == 20 && reader->depth == 1);
+    CHECK(reader.version() == 1);
+    CHECK(held->limit == 10);
+    CHECK(held.use_count() == 1);
+
+    // reload starts from the current settings, a failed one publishes nothing
+    CHECK(reload(published, "--depth=4"));
+    CHECK(reader->limit == 20 && reader->depth == 4);
+    CHECK(!reload(published, "--depth=x"));
+    CHECK(published.version() == 2);
+    CHECK(reader->depth == 4);
+
+    published.publish(std::make_shared<const Settings>(Settings { 30, 5 }));
+    CHECK(published.version() == 3);
+    CHECK(reader->limit == 30 && reader.version() == 3);
+    CHECK(published.reader()->depth == 5);
+
+    // readers on other threads never observe a version going back or a torn instance
+    published.publish(std::make_shared<const Settings>(Settings { 30, 31 }));
+    std::atomic<bool> done {};
+    std::atomic<unsigned> errors {};
+    std::thread threads[2];
+    for(auto& thread : threads) thread = std::thread { [&] {
+        auto local = published.reader();
+        unsigned last = local->limit;
+        while(!done.load(std::memory_order_acquire)) {
+            const auto& current = *local;
+            if (current.limit < last || current.depth != current.limit + 1) ++errors;
+            last = current.limit;
+        }
+    } };
+    for(unsigned limit = 31; limit < 2000; ++limit)
+        published.publish(std::make_shared<const Settings>(Settings { limit, limit + 1 }));
+    done.store(true, std::memory_order_release);
+    for(auto& thread : threads) thread.join();
+    CHECK(errors == 0);
+    CHECK(reader->limit == 1999);
+    CHECK(held->limit == 10);
+    return test::failures != 0;
+}
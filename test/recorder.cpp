@@ -0,0 +1,49 @@
+#include <simplearg/recorder.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include "check.h"
+#include "directory.h"
+using namespace simplearg;
+
+namespace {
+
+struct Server {
+    std::string log {};
+    bool note(std::string_view name, Arguments&) {
+        log += name;
+        return true;
+    }
+    static constexpr Parameters<Server, 3> params = {{
+        { &Server::note, "now", "an immediate call", "" },
+        { &Server::note, "--later", "a deferred call", "", Execution::deferred },
+        { &Server::note, "--aside", "a parallel call", "", Execution::parallel },
+    }};
+};
+
+} // namespace
+
+int main() {
+    test::Directory dir {};
+    if (!CHECK(!dir.name.empty())) return 1;
+    const auto path = dir.name + "/log.rec";
+    {
+        Recorder recorder { path };
+        Server server {};
+        const char* values[] = { "--later", "now", "--aside" };
+        Arguments args { 3, values };
+        CHECK(recorder.parse(args, server, Server::params));
+        CHECK(server.log == "now--aside--later");
+    }
+    std::ifstream file { path, std::ios::binary };
+    const std::string data { std::istreambuf_iterator<char> { file }, {} };
+    const std::string recorded { "--later\0now\0--aside\0now\0--aside\0--later\0", 40 };
+    CHECK(data.size() == sizeof(Recording::magic) + sizeof(Recording::Record) + recorded.size());
+    CHECK(data.compare(data.size() - recorded.size(), recorded.size(), recorded) == 0);
+    Replay replay {};
+    CHECK(replay.load(path));
+    Server server {};
+    const auto stats = replay.run(server, Server::params);
+    CHECK(stats.records == 1 && stats.failures == 0 && stats.mismatches == 0);
+    return test::failures != 0;
+}
@@ -0,0 +1,63 @@
+#include <simplearg/response.h>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "directory.h"
+using namespace simplearg;
+
+namespace {
+
+struct Words {
+    std::vector<std::string> words {};
+    std::string option {};
+    bool word(std::string_view name, Arguments&) {
+        words.emplace_back(name);
+        return true;
+    }
+    bool set(std::string_view, Arguments& args) { return args.get(option); }
+    static constexpr Parameters<Words, 2> params = {{
+        { &Words::set, "--option=", "an option", "" },
+        { &Words::word, "", "any word", "" },
+    }};
+};
+
+} // namespace
+
+int main() {
+    test::Directory dir {};
+    if (!CHECK(!dir.name.empty())) return 1;
+    const auto inner = dir.write("inner.rsp", "c # comment\nd\n");
+    const auto outer = dir.write("outer.rsp", ("b @" + inner + " f").c_str());
+    const auto first = dir.write("first.rsp", ("x @" + dir.name + "/second.rsp").c_str());
+    dir.write("second.rsp", ("y @" + first).c_str());
+    {
+        ResponseFiles files {};
+        const auto at = '@' + outer;
+        const char* values[] = { "a", at.c_str(), "g", "--option=@outer" };
+        Arguments args { 4, values, files };
+        Words words {};
+        CHECK(args.parse(words, Words::params));
+        CHECK((words.words == std::vector<std::string> { "a", "b", "c", "d", "f", "g" }));
+        CHECK(words.option == "@outer");
+    }
+    {
+        ResponseFiles files {};
+        const auto at = '@' + first;
+        const char* values[] = { at.c_str() };
+        Arguments args { 1, values, files };
+        Words words {};
+        CHECK(!args.parse(words, Words::params));
+        CHECK((words.words == std::vector<std::string> { "x", "y" }));
+        CHECK(args.errors() == "recursive response file '" + first + '\'');
+    }
+    {
+        ResponseFiles files {};
+        const auto at = "@" + dir.name + "/missing.rsp";
+        const char* values[] = { "a", at.c_str() };
+        Arguments args { 2, values, files };
+        Words words {};
+        CHECK(!args.parse(words, Words::params));
+        CHECK(args.errors() == "cannot read response file '" + dir.name + "/missing.rsp'");
+    }
+    return test::failures != 0;
+}
@@ -0,0 +1,79 @@
+#include <simplearg/script.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "check.h"
+#include "directory.h"
+using namespace simplearg;
+
+namespace {
+
+struct Counter {
+    std::vector<unsigned> values {};
+    bool add(std::string_view, Arguments& args) {
+        unsigned value {};
+        if (!args.get(value)) return false;
+        values.push_back(value);
+        return true;
+    }
+    static constexpr Parameters<Counter, 1> params = {{
+        { &Counter::add, "add", "adds a number", "" },
+    }};
+};
+
+} // namespace
+
+int main() {
+    test::Directory dir {};
+    if (!CHECK(!dir.name.empty())) return 1;
+    std::string text {}, failing {};
+    std::vector<unsigned> expected {};
+    for(unsigned i = 1; i <= 3000; ++i) {
+        text += "add " + std::to_string(i) + (i % 7 ? "" : "  # comment") + (i % 11 ? "\n" : "\n\n");
+        expected.push_back(i);
+    }
+    const auto path = dir.write("script.txt", text.c_str());
+    for(std::size_t batch_size : { 1, 7, 100, 4096, 64 * 1024 })
+        for(std::size_t batches : { 2, 8 }) {
+            Counter counter {};
+            Script<Counter> script { counter, Counter::params, batches, batch_size };
+            CHECK(script.run(path));
+            CHECK(counter.values == expected);
+            CHECK(script.stats().lines == expected.size());
+            CHECK(script.errors().empty());
+        }
+
+    // execution stops at the first failed line, reported with its file and line
+    const auto bad = dir.write("bad.txt", "add 1\n\n# comment\nadd 2\nadd x\nadd 3\n");
+    for(std::size_t batch_size : { 1, 4096 }) {
+        Counter counter {};
+        Script<Counter> script { counter, Counter::params, 2, batch_size };
+        CHECK(!script.run(bad));
+        CHECK((counter.values == std::vector<unsigned> { 1, 2 }));
+        CHECK(script.errors() == bad + ":5: expects number in place of 'x'");
+    }
+    {
+        Counter counter {};
+        Script<Counter> script { counter, Counter::params };
+        CHECK(!script.run(dir.name + "/missing.txt"));
+        CHECK(script.errors() == "cannot read '" + dir.name + "/missing.txt'");
+    }
+
+    // lines from a pipe are dispatched as they arrive, a failure returns while the writer is still open
+    int fds[2];
+    if (!CHECK(::pipe(fds) == 0)) return 1;
+    std::thread writer { [fd = fds[1]] {
+        [[maybe_unused]] auto put = ::write(fd, "add 1\nadd 2\n", 12);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        put = ::write(fd, "add y\nadd 3\n", 12);
+    } };
+    Counter counter {};
+    Script<Counter> script { counter, Counter::params };
+    CHECK(!script.run(fds[0], "pipe"));
+    CHECK((counter.values == std::vector<unsigned> { 1, 2 }));
+    CHECK(script.errors() == "pipe:3: expects number in place of 'y'");
+    writer.join();
+    ::close(fds[1]);
+    ::close(fds[0]);
+    return test::failures != 0;
+}
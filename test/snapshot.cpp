@@ -0,0 +1,108 @@
+#include <simplearg/snapshot.h>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include "check.h"
+#include "directory.h"
+using namespace simplearg;
+
+namespace {
+
+struct Config {
+    std::vector<std::string> words {};
+    unsigned port {};
+    bool word(std::string_view name, Arguments&) {
+        words.emplace_back(name);
+        return true;
+    }
+    bool set(std::string_view, Arguments& args) { return args.get(port); }
+    static constexpr Parameters<Config, 2> params = {{
+        { &Config::set, "--port=", "port number", "" },
+        { &Config::word, "", "any word", "" },
+    }};
+};
+
+bool touch(const std::string& path, const struct stat& st) {
+    const struct timespec times[2] = { st.st_atim, st.st_mtim };
+    return ::utimensat(AT_FDCWD, path.c_str(), times, 0) == 0;
+}
+
+} // namespace
+
+int main() {
+    test::Directory dir {};
+    if (!CHECK(!dir.name.empty())) return 1;
+    const auto source = dir.write("server.conf", "--port=8080 # comment\nalpha beta\n");
+    std::string errors {};
+    CHECK(Snapshot::path(source.c_str()) == source + ".argv");
+    CHECK(Snapshot::make(source.c_str(), errors));
+    CHECK(errors.empty());
+    {
+        Snapshot snapshot {};
+        CHECK(!snapshot);
+        CHECK(snapshot.load(source.c_str(), errors));
+        CHECK(snapshot && snapshot.size() == 3);
+        CHECK(snapshot.verify(source.c_str(), errors));
+        CHECK(errors.empty());
+        Config config {};
+        auto args = snapshot.arguments();
+        CHECK(args.parse(config, Config::params));
+        CHECK(config.port == 8080);
+        CHECK((config.words == std::vector<std::string> { "alpha", "beta" }));
+    }
+
+    // a source rewritten after make is detected by size or by modification time
+    struct stat original {};
+    CHECK(::stat(source.c_str(), &original) == 0);
+    dir.write("server.conf", "--port=9090 # comment\nalpha beta delta\n");
+    {
+        Snapshot snapshot {};
+        CHECK(!snapshot.load(source.c_str(), errors));
+        CHECK(!snapshot);
+        CHECK(errors == "outdated snapshot '" + source + ".argv'");
+    }
+    errors.clear();
+    dir.write("server.conf", "--port=9090 # comment\nalpha beta\n");
+    struct stat later = original;
+    later.st_mtim.tv_sec += 10;
+    CHECK(touch(source, later));
+    {
+        Snapshot snapshot {};
+        CHECK(!snapshot.load(source.c_str(), errors));
+        CHECK(errors == "outdated snapshot '" + source + ".argv'");
+    }
+
+    // the same size and time with different content passes load, verify detects it by hash
+    errors.clear();
+    CHECK(touch(source, original));
+    {
+        Snapshot snapshot {};
+        CHECK(snapshot.load(source.c_str(), errors));
+        CHECK(!snapshot.verify(source.c_str(), errors));
+        CHECK(errors == "hash mismatch for '" + source + '\'');
+    }
+
+    // a rebuilt snapshot loads again, a truncated one is rejected
+    errors.clear();
+    CHECK(Snapshot::make(source.c_str(), errors));
+    {
+        Snapshot snapshot {};
+        CHECK(snapshot.load(source.c_str(), errors));
+        CHECK(snapshot.verify(source.c_str(), errors));
+        Config config {};
+        auto args = snapshot.arguments();
+        CHECK(args.parse(config, Config::params));
+        CHECK(config.port == 9090);
+    }
+    CHECK(::truncate((source + ".argv").c_str(), sizeof(Snapshot::Header) + 2) == 0);
+    {
+        Snapshot snapshot {};
+        CHECK(!snapshot.load(source.c_str(), errors));
+        CHECK(errors == "invalid snapshot '" + source + ".argv'");
+        CHECK(!snapshot.verify(source.c_str(), errors));
+    }
+    errors.clear();
+    CHECK(!Snapshot::make((dir.name + "/missing.conf").c_str(), errors));
+    CHECK(errors == "cannot read '" + dir.name + "/missing.conf'");
+    return test::failures != 0;
+}
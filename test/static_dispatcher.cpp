@@ -0,0 +1,138 @@
+#include <simplearg/static_dispatcher.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "check.h"
+using namespace simplearg;
+
+namespace {
+
+struct Verbs {
+    int called = 0;
+    bool verb(std::string_view, Arguments&) {
+        ++called;
+        return true;
+    }
+};
+
+// Several hundred verbs declared in reverse order of names, each with two aliases
+// scattered over the table, so that routes are far from sorted
+constexpr std::size_t size = 600;
+struct Names {
+    char names[size][5];
+    char aliases[size][10];
+};
+constexpr void print(char* out, char prefix, std::size_t number) {
+    out[0] = prefix;
+    out[1] = static_cast<char>('0' + number / 100);
+    out[2] = static_cast<char>('0' + number / 10 % 10);
+    out[3] = static_cast<char>('0' + number % 10);
+}
+constexpr Names make_names() {
+    Names result {};
+    for(std::size_t i = 0; i < size; ++i) {
+        print(result.names[i], 'v', size - 1 - i);
+        print(result.aliases[i], 'a', (i * 119) % size);
+        result.aliases[i][4] = ' ';
+        print(result.aliases[i] + 5, 'b', (i * 7) % size);
+    }
+    return result;
+}
+constexpr Names names = make_names();
+template<std::size_t ... I>
+constexpr Parameters<Verbs, size> make_params(std::index_sequence<I...>) {
+    return {{ Parameter<Verbs> { &Verbs::verb, names.names[I], "", names.aliases[I] }... }};
+}
+constexpr Parameters<Verbs, size> params = make_params(std::make_index_sequence<size> {});
+using Large = StaticDispatcher<params>;
+
+constexpr bool sorted() {
+    for(auto route = Large::routes_begin(Large::root()) + 1; route < Large::routes_end(Large::root()); ++route)
+        if (route->name < route[-1].name) return false;
+    return true;
+}
+static_assert(Large::routes_end(Large::root()) - Large::routes_begin(Large::root()) == size * 3);
+static_assert(sorted());
+static_assert(Large::find("v000") == &params[size - 1]);
+static_assert(Large::find("v599") == &params[0]);
+static_assert(Large::find("a119") == &params[1]);
+static_assert(Large::find("b014") == &params[2]);
+static_assert(Large::find("v600") == nullptr);
+
+// Nested tables of group verb --opt commands, with names repeated within a table
+struct Tool {
+    std::vector<std::string> log {};
+    bool verb(std::string_view name, Arguments&) {
+        log.emplace_back(name);
+        return true;
+    }
+    bool other(std::string_view name, Arguments&) {
+        log.push_back('*' + std::string { name });
+        return true;
+    }
+    bool add(std::string_view name, Arguments& args) {
+        std::string value {};
+        if (!args.get(value)) return false;
+        log.push_back(std::string { name } + ' ' + value);
+        return true;
+    }
+};
+constexpr Parameters<Tool, 3> branch_params = {{
+    { &Tool::verb, "list", "lists branches", "ls" },
+    { &Tool::verb, "--all", "all branches", "-a" },
+    { &Tool::other, "list", "lists branches, declared last", "" },
+}};
+constexpr Parameters<Tool, 4> remote_params = {{
+    { &Tool::add, "add", "adds a remote", "" },
+    { &Tool::verb, "remove", "removes a remote", "rm" },
+    { &Tool::verb, "--force", "forces the change", "-f" },
+    { branch_params, "branch", "remote branches", "", &Tool::verb },
+}};
+constexpr Parameters<Tool, 5> tool_params = {{
+    { &Tool::verb, "status", "reports status", "st" },
+    { remote_params, "remote", "manages remotes", "", &Tool::verb },
+    { &Tool::add, "add", "adds a file", "" },
+    { &Tool::other, "status", "reports status, declared last", "" },
+    { &Tool::other, "start", "starts", "st" },
+}};
+using Nested = StaticDispatcher<tool_params>;
+static_assert(Nested::find("status") == &tool_params[3]);
+static_assert(Nested::find("st") == &tool_params[4]);
+static_assert(Nested::find(Nested::child(Nested::root(), tool_params[1]), "rm") == &remote_params[1]);
+
+template<class D>
+std::vector<std::string> run(std::initializer_list<const char*> values, const D& dispatcher) {
+    std::vector<const char*> argv { values };
+    Arguments args { static_cast<int>(argv.size()), argv.data() };
+    Tool tool {};
+    if (!args.parse(tool, dispatcher)) tool.log.push_back(args.errors());
+    return tool.log;
+}
+
+// Static and map based dispatchers agree on every command
+void nested(std::initializer_list<const char*> values, const std::vector<std::string>& expected) {
+    CHECK(run(values, Nested {}) == expected);
+    CHECK(run(values, Dispatcher<Tool> { tool_params }) == expected);
+}
+
+} // namespace
+
+int main() {
+    using Log = std::vector<std::string>;
+    nested({ "add", "x", "remote", "add", "origin", "--force" }, Log { "add x", "remote", "add origin", "--force" });
+    nested({ "remote", "rm", "-f", "branch", "ls", "-a" }, Log { "remote", "rm", "-f", "branch", "ls", "-a" });
+    nested({ "remote", "branch", "list" }, Log { "remote", "branch", "*list" });
+    nested({ "status", "st" }, Log { "*status", "*st" });
+    nested({ "remote", "status" }, Log { "remote", "Unknown verb 'status' expected one of: add remove --force branch" });
+
+    Verbs verbs {};
+    const char* values[] = { "a238", "v001", "b014" };
+    Arguments args { 3, values };
+    CHECK(args.parse(verbs, Large {}));
+    CHECK(verbs.called == 3);
+    const char* unknown[] = { "v001", "v600" };
+    Arguments failed { 2, unknown };
+    CHECK(!failed.parse(verbs, Large {}));
+    CHECK(failed.errors() == "Unknown verb 'v600', did you mean: v500 v400 v300");
+    return test::failures != 0;
+}
@@ -0,0 +1,62 @@
+#include <simplearg/watcher.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "directory.h"
+using namespace simplearg;
+
+namespace {
+
+struct Config {
+    std::vector<std::string> lines {};
+    bool set(std::string_view name, Arguments& args) {
+        std::string value {};
+        if (!args.get(value)) return false;
+        lines.push_back(std::string { name } + value);
+        return true;
+    }
+    static constexpr Parameters<Config, 2> params = {{
+        { &Config::set, "--a=", "a value", "" },
+        { &Config::set, "--b=", "b value", "" },
+    }};
+    std::vector<std::string> take() { return std::move(lines); }
+};
+
+using Lines = std::vector<std::string>;
+
+} // namespace
+
+int main() {
+    test::Directory dir {};
+    if (!CHECK(!dir.name.empty())) return 1;
+    const auto path = dir.write("app.conf", "--a=1\n--b=2\n");
+    Config config {};
+    Watcher<Config> watcher { config, Config::params };
+    CHECK(watcher.add(path));
+    CHECK((config.take() == Lines { "--a=1", "--b=2" }));
+
+    dir.write("app.conf", "--a=1\n--b=3\n--c=4\n");
+    CHECK(!watcher.poll(1000));
+    CHECK((config.take() == Lines { "--b=3" }));
+    CHECK(watcher.poll(0));
+    CHECK(!watcher.errors().empty());
+    CHECK(watcher.errors().empty());
+
+    // the failed line is dispatched again, succeeded ones are not
+    dir.write("app.conf", "--a=1\n--b=3\n--c=4\n# comment\n");
+    CHECK(!watcher.poll(1000));
+    CHECK(config.take().empty());
+    CHECK(!watcher.errors().empty());
+
+    const auto renamed = dir.write("app.conf.new", "--a=1\n--b=5\n");
+    CHECK(std::rename(renamed.c_str(), path.c_str()) == 0);
+    CHECK(watcher.poll(1000));
+    CHECK((config.take() == Lines { "--b=5" }));
+    CHECK(watcher.errors().empty());
+
+    dir.write("other.conf", "--a=7\n");
+    CHECK(watcher.poll(100));
+    CHECK(config.take().empty());
+    return test::failures != 0;
+}